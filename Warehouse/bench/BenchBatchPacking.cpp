@@ -0,0 +1,86 @@
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t bays = 400;       ///< OverSize bays of the warehouse
+constexpr float bayCapacity = 10.0f;    ///< Capacity of every bay
+
+/**
+ * @brief A truckload of racks of mixed sizes, slightly more than the bays hold
+ */
+std::vector<warehouseInterface::IProductPtr> truckload(std::uint64_t seed)
+{
+    std::vector<warehouseInterface::IProductPtr> products{};
+    double volume = 0.0;
+    while (volume < 1.05 * static_cast<double>(bays) * static_cast<double>(bayCapacity))
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto size = 0.5f + static_cast<float>(seed >> 40) / static_cast<float>(1 << 24) * 5.5f;
+        products.push_back(std::make_unique<warehouse::IndustrialServerRack>("Rack " + std::to_string(products.size()), size));
+        volume += static_cast<double>(size);
+    }
+    return products;
+}
+
+struct Result
+{
+    double seconds;
+    double utilization;
+};
+
+/**
+ * @brief Deliver one truckload and measure the time and the share of bay capacity used
+ */
+Result run(bool packed, std::uint64_t seed)
+{
+    warehouse::Warehouse warehouse{};
+    warehouse.configureDelivery(warehouse::DeliveryOptions{4096, warehouse::PlacementPolicy::firstFit, packed});
+    for (std::size_t i = 0; i < bays; ++i)
+        warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(bayCapacity));
+
+    auto products = truckload(seed);
+    const auto start = Clock::now();
+    warehouse.newDelivery(std::move(products));
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    picojson::value report;
+    picojson::parse(report, warehouse.getOccupancyReport());
+    double occupancy = 0.0;
+    for (const auto &department : report.get("departmentsOccupancy").get<picojson::array>())
+        occupancy += department.get("occupancy").get<double>();
+    return {seconds, occupancy / (static_cast<double>(bays) * static_cast<double>(bayCapacity))};
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5;
+    std::printf("one truckload into %zu bays of %.0f, %zu rounds\n", bays, static_cast<double>(bayCapacity), rounds);
+    std::printf("  mode      utilization  ms per delivery\n");
+    for (const bool packed : {false, true})
+    {
+        double seconds = 0.0;
+        double utilization = 0.0;
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            const auto result = run(packed, round + 1);
+            seconds += result.seconds;
+            utilization += result.utilization;
+        }
+        std::printf("  %-8s  %10.2f%%  %15.2f\n",
+                    packed ? "packed" : "greedy",
+                    100.0 * utilization / static_cast<double>(rounds),
+                    1000.0 * seconds / static_cast<double>(rounds));
+    }
+    return 0;
+}
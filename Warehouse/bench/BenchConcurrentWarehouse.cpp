@@ -0,0 +1,116 @@
+#include <Warehouse/ConcurrentWarehouse.hpp>
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Warehouse serialized behind one mutex, the way callers shared it before ConcurrentWarehouse
+ */
+class LockedWarehouse
+{
+public:
+    LockedWarehouse() : mutex_(), warehouse_() {}
+
+    void addDepartment(warehouseInterface::IDepartmentPtr department) { warehouse_.addDepartment(std::move(department)); }
+
+    void newDelivery(std::vector<warehouseInterface::IProductPtr> products)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        warehouse_.newDelivery(std::move(products));
+    }
+
+    std::size_t newOrder(const std::string &order)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return warehouse_.newOrder(order).products.size();
+    }
+
+private:
+    std::mutex mutex_;
+    warehouse::Warehouse warehouse_;
+};
+
+std::size_t take(warehouse::ConcurrentWarehouse &warehouse, const std::string &order)
+{
+    return warehouse.newOrder(order).products.size();
+}
+
+std::size_t take(LockedWarehouse &warehouse, const std::string &order) { return warehouse.newOrder(order); }
+
+/**
+ * @brief Every thread delivers products to its own department kinds and orders them back
+ *
+ * FIFO and LIFO departments shared by several threads serve only part of the orders, the work per
+ * call is the same for both warehouses.
+ */
+template <typename WarehouseType>
+double run(std::size_t threadCount, std::size_t rounds)
+{
+    WarehouseType warehouse{};
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(1e9f));
+        warehouse.addDepartment(std::make_unique<warehouse::HazardousDepartment>(1e9f));
+        warehouse.addDepartment(std::make_unique<warehouse::ColdRoomDepartment>(1e9f));
+    }
+
+    const auto start = Clock::now();
+    std::vector<std::thread> threads{};
+    for (std::size_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&warehouse, rounds, t]() {
+            const auto prefix = "Item " + std::to_string(t) + "-";
+            for (std::size_t round = 0; round < rounds; ++round)
+            {
+                std::vector<warehouseInterface::IProductPtr> products{};
+                std::string order = "{\"order\": [";
+                for (std::size_t i = 0; i < 20; ++i)
+                {
+                    const auto name = prefix + std::to_string(i);
+                    if (t % 3 == 0)
+                        products.push_back(std::make_unique<warehouse::IndustrialServerRack>(name, 1.0f));
+                    else if (t % 3 == 1)
+                        products.push_back(std::make_unique<warehouse::ExplosiveBarrel>(name, 1.0f));
+                    else
+                        products.push_back(std::make_unique<warehouse::AstronautsIceCream>(name, 1.0f));
+                    order += (i ? ",{\"name\":\"" : "{\"name\":\"") + name + "\"}";
+                }
+                order += "]}";
+                warehouse.newDelivery(std::move(products));
+                take(warehouse, order);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(threadCount * rounds * 20) / seconds;
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    std::printf("products delivered and ordered per second\n");
+    std::printf("  threads  Warehouse + mutex  ConcurrentWarehouse\n");
+    for (std::size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        std::printf("  %7zu  %17.0f  %19.0f\n",
+                    threads,
+                    run<LockedWarehouse>(threads, rounds),
+                    run<warehouse::ConcurrentWarehouse>(threads, rounds));
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <Warehouse/DepartmentRouter.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+std::vector<warehouseInterface::IProductPtr> racks(std::size_t count)
+{
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        products.push_back(std::make_unique<warehouse::IndustrialServerRack>("Rack " + std::to_string(i), 1.0f));
+    return products;
+}
+
+/**
+ * @brief Fill the bays one after the other with Warehouse::newDelivery, products placed per second
+ */
+double runWarehouse(std::size_t bays, std::size_t count)
+{
+    warehouse::Warehouse warehouse{};
+    for (std::size_t i = 0; i < bays; ++i)
+        warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(2.0f));
+
+    auto products = racks(count);
+    const auto start = Clock::now();
+    const auto report = warehouse.newDelivery(std::move(products));
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return report.empty() ? 0.0 : static_cast<double>(count) / seconds;
+}
+
+/**
+ * @brief The same placements with a walk over the routed candidates, products placed per second
+ */
+double runRouterWalk(std::size_t bays, std::size_t count)
+{
+    std::vector<warehouseInterface::IDepartmentPtr> departments{};
+    for (std::size_t i = 0; i < bays; ++i)
+        departments.push_back(std::make_unique<warehouse::OverSizeElectronicDepartment>(2.0f));
+    warehouse::DepartmentRouter router{};
+    router.rebuild(departments);
+
+    auto products = racks(count);
+    std::size_t placed = 0;
+    const auto start = Clock::now();
+    for (auto &product : products)
+    {
+        const auto size = product->itemSize();
+        for (auto *department : router.candidates(product->itemFlags()))
+        {
+            if (warehouse::DepartmentRouter::hasRoomFor(*department, size) && department->addItem(std::move(product)))
+            {
+                ++placed;
+                break;
+            }
+        }
+    }
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return placed == 0 ? 0.0 : static_cast<double>(count) / seconds;
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t bays = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    const std::size_t count = 2 * bays;
+    std::printf("first fit of %zu racks into %zu bays holding two each, products placed per second\n", count, bays);
+    std::printf("  FitIndex  router walk\n");
+    std::printf("  %8.0f  %11.0f\n", runWarehouse(bays, count), runRouterWalk(bays, count));
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <Departments/DepartmentsList.hpp>
+#include <Departments/ItemStore.hpp>
+#include <Products/ProductsList.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+warehouseInterface::IProductPtr makeProduct(std::size_t i, std::size_t distinctNames)
+{
+    const auto name = "Product " + std::to_string(i % distinctNames);
+    const auto size = 0.1f + static_cast<float>(i % 97) * 0.37f;
+    if (i % 4 == 0)
+        return std::make_unique<warehouse::GlassWare>(name, size);
+    return std::make_unique<warehouse::IndustrialServerRack>(name, size);
+}
+
+void run(std::size_t itemCount, std::size_t distinctNames)
+{
+    // Previous layout: one heap object per item behind a deque of owning pointers
+    std::deque<warehouseInterface::IProductPtr> objects{};
+    warehouse::ItemStore store;
+    for (std::size_t i = 0; i < itemCount; ++i)
+    {
+        objects.push_back(makeProduct(i, distinctNames));
+        store.push(makeProduct(i, distinctNames));
+    }
+
+    const warehouse::ProductQuery query{std::string("GlassWare"), std::string("Product 8")};
+    const auto symbols = query.symbols();
+    constexpr std::size_t rounds = 5;
+
+    auto start = Clock::now();
+    std::size_t objectMatches = 0;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (const auto &product : objects)
+            objectMatches += static_cast<std::size_t>(query.matches(*product));
+    }
+    const double objectScan = millisecondsSince(start) / static_cast<double>(rounds);
+
+    start = Clock::now();
+    std::size_t storeMatches = 0;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        store.forEach([&](warehouse::ItemStore::Position position) {
+            storeMatches += static_cast<std::size_t>(store.matches(symbols, position));
+        });
+    }
+    const double storeScan = millisecondsSince(start) / static_cast<double>(rounds);
+
+    start = Clock::now();
+    double objectOccupancy = 0.0;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        objectOccupancy = 0.0;
+        for (const auto &product : objects)
+            objectOccupancy += static_cast<double>(product->itemSize());
+    }
+    const double objectSum = millisecondsSince(start) / static_cast<double>(rounds);
+
+    start = Clock::now();
+    double storeOccupancy = 0.0;
+    for (std::size_t round = 0; round < rounds; ++round)
+        storeOccupancy = store.occupancy();
+    const double storeSum = millisecondsSince(start) / static_cast<double>(rounds);
+
+    std::printf("items %zu, distinct names %zu\n", itemCount, distinctNames);
+    std::printf("  query scan     objects %9.2f ms   columns %9.2f ms   (%.1fx, %zu/%zu matches)\n",
+                objectScan,
+                storeScan,
+                objectScan / storeScan,
+                objectMatches / rounds,
+                storeMatches / rounds);
+    std::printf("  occupancy sum  objects %9.2f ms   columns %9.2f ms   (%.1fx, %s)\n",
+                objectSum,
+                storeSum,
+                objectSum / storeSum,
+                objectOccupancy == storeOccupancy ? "equal" : "DIFFERENT");
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t itemCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    run(itemCount, 1000);
+    return 0;
+}
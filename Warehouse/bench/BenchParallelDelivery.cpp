@@ -0,0 +1,74 @@
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A container unload: products of every class, routed to five independent department groups
+ */
+std::vector<warehouseInterface::IProductPtr> unload(std::size_t count)
+{
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto name = "Item " + std::to_string(i);
+        switch (i % 5)
+        {
+            case 0:
+                products.push_back(std::make_unique<warehouse::IndustrialServerRack>(name, 1.0f));
+                break;
+            case 1:
+                products.push_back(std::make_unique<warehouse::GlassWare>(name, 1.0f));
+                break;
+            case 2:
+                products.push_back(std::make_unique<warehouse::ElectronicParts>(name, 1.0f));
+                break;
+            case 3:
+                products.push_back(std::make_unique<warehouse::AstronautsIceCream>(name, 1.0f));
+                break;
+            default:
+                products.push_back(std::make_unique<warehouse::TV>(name, 1.0f));
+                break;
+        }
+    }
+    return products;
+}
+
+/**
+ * @brief Deliver one unload and return the products placed per second
+ */
+double run(std::size_t threads, std::size_t count)
+{
+    warehouse::Warehouse warehouse(threads > 1 ? std::make_shared<warehouse::TaskScheduler>(threads) : nullptr);
+    warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(1e9f));
+    warehouse.addDepartment(std::make_unique<warehouse::SpecialDepartment>(1e9f));
+    warehouse.addDepartment(std::make_unique<warehouse::SmallElectronicDepartment>(1e9f));
+    warehouse.addDepartment(std::make_unique<warehouse::ColdRoomDepartment>(1e9f));
+
+    auto products = unload(count);
+    const auto start = Clock::now();
+    const auto report = warehouse.newDelivery(std::move(products));
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return report.empty() ? 0.0 : static_cast<double>(count) / seconds;
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::printf("products placed per second, one delivery of %zu products\n", count);
+    std::printf("  threads  newDelivery\n");
+    for (std::size_t threads = 1; threads <= 8; threads *= 2)
+        std::printf("  %7zu  %11.0f\n", threads, run(threads, count));
+    return 0;
+}
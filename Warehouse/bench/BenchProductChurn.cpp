@@ -0,0 +1,139 @@
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double microsecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Read a memory figure in KiB from /proc/self/status, 0 where it is not available
+ */
+long statusKiB(const char *field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line{};
+    const auto length = std::strlen(field);
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, length, field) == 0)
+            return std::strtol(line.c_str() + length + 1, nullptr, 10);
+    }
+    return 0;
+}
+
+double percentile(std::vector<double> samples, double fraction)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1))];
+}
+
+/**
+ * @brief Create and destroy products with interleaved lifetimes, without any warehouse work
+ */
+void lifecycle(std::size_t rounds, std::size_t live)
+{
+    const warehouse::ProductFactory factory{};
+    std::vector<warehouseInterface::IProductPtr> products(live);
+    std::mt19937 random(7);
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < rounds * live; ++i)
+        products[random() % live] = factory.createProduct(i % 2 ? "TV" : "GlassWare", "Lifecycle", 1.0f);
+    std::printf("  product replacement %.1f ns with %zu live products\n",
+                microsecondsSince(start) * 1e3 / static_cast<double>(rounds * live),
+                live);
+}
+
+/**
+ * @brief Keep a stock of products, deliver a batch and order as many random products per round
+ *
+ * Products share a fixed set of names, so the stock and the interned names stay the same size and
+ * the memory growth comes from the allocator alone.
+ */
+void run(std::size_t rounds, std::size_t stock, std::size_t batch)
+{
+    warehouse::Warehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(1e9f));
+    warehouse.addDepartment(std::make_unique<warehouse::SmallElectronicDepartment>(1e9f));
+
+    const warehouse::ProductFactory factory{};
+    std::mt19937 random(42);
+    constexpr std::size_t nameCount = 20000;
+    std::size_t next = 0;
+    const auto deliver = [&](std::size_t count) {
+        std::vector<warehouseInterface::IProductPtr> products{};
+        for (std::size_t i = 0; i < count; ++i, ++next)
+        {
+            const auto size = 0.1f + static_cast<float>(next % 7) * 0.3f;
+            products.push_back(factory.createProduct(next % 2 ? "IndustrialServerRack" : "ElectronicParts",
+                                                     "Part " + std::to_string(next % nameCount),
+                                                     size));
+        }
+        warehouse.newDelivery(std::move(products));
+    };
+    deliver(stock);
+    const auto rssStocked = statusKiB("VmRSS:");
+
+    std::vector<double> latencies{};
+    std::size_t taken = 0;
+    const auto start = Clock::now();
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        const auto roundStart = Clock::now();
+        deliver(batch);
+        std::string order = "{\"order\": [";
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            const auto part = random() % nameCount;
+            order += (i ? ",{\"name\":\"Part " : "{\"name\":\"Part ") + std::to_string(part) + "\"}";
+        }
+        order += "]}";
+        taken += warehouse.newOrder(order).products.size();
+        latencies.push_back(microsecondsSince(roundStart));
+    }
+    const auto seconds = microsecondsSince(start) / 1e6;
+
+    std::printf("  %zu rounds of %zu products in %.2f s, %.0f products per second, %zu ordered products found\n",
+                rounds,
+                batch,
+                seconds,
+                static_cast<double>(rounds * batch) / seconds,
+                taken);
+    std::printf("  round latency p50 %.0f us, p99 %.0f us, max %.0f us\n",
+                percentile(latencies, 0.5),
+                percentile(latencies, 0.99),
+                percentile(latencies, 1.0));
+    std::printf("  RSS after stocking %ld KiB, after churn %ld KiB, peak %ld KiB\n",
+                rssStocked,
+                statusKiB("VmRSS:"),
+                statusKiB("VmHWM:"));
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const bool pooled = argc > 1 && std::strcmp(argv[1], "pooled") == 0;
+    const std::size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    if (!warehouse::ProductFactory::configure(warehouse::ProductFactoryOptions{pooled}))
+        return 1;
+
+    std::printf("%s allocation (pass \"pooled\" or \"malloc\" as the first argument)\n", pooled ? "pooled" : "malloc");
+    lifecycle(100, 100000);
+    run(rounds, 100000, 1000);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <Factory/ProductFactory.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// The replaced global allocation functions pair malloc with free
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+namespace
+{
+std::size_t allocations = 0;
+}  // namespace
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void print(const char *label, double milliseconds, std::size_t allocationCount, std::size_t count)
+{
+    std::printf("  %-28s %9.2f ms  %9zu allocations (%.2f per item)\n",
+                label,
+                milliseconds,
+                allocationCount,
+                static_cast<double>(allocationCount) / static_cast<double>(count));
+}
+
+void run(std::size_t itemCount, std::size_t distinctNames)
+{
+    const char *classes[] = {"GlassWare", "IndustrialServerRack", "TV", "AcetoneBarrel"};
+    std::vector<warehouse::ProductSpec> specs{};
+    specs.reserve(itemCount);
+    for (std::size_t i = 0; i < itemCount; ++i)
+        specs.push_back(warehouse::ProductSpec{classes[i % 4], "Supplier item " + std::to_string(i % distinctNames), 1.0f});
+    std::printf("items %zu, distinct names %zu\n", itemCount, distinctNames);
+
+    const warehouse::ProductFactory factory{};
+    {
+        auto allocationsBefore = allocations;
+        auto start = Clock::now();
+        std::vector<warehouseInterface::IProductPtr> products{};
+        products.reserve(itemCount);
+        for (const auto &spec : specs)
+            products.push_back(factory.createProduct(spec.className, spec.name, spec.size));
+        print("createProduct loop", millisecondsSince(start), allocations - allocationsBefore, itemCount);
+
+        allocationsBefore = allocations;
+        start = Clock::now();
+        products.clear();
+        print("  destruction", millisecondsSince(start), allocations - allocationsBefore, itemCount);
+    }
+    {
+        auto allocationsBefore = allocations;
+        auto start = Clock::now();
+        auto products = factory.createProducts(specs);
+        print("createProducts", millisecondsSince(start), allocations - allocationsBefore, itemCount);
+
+        allocationsBefore = allocations;
+        start = Clock::now();
+        products.clear();
+        print("  destruction", millisecondsSince(start), allocations - allocationsBefore, itemCount);
+    }
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t itemCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    run(itemCount, 10000);
+    return 0;
+}
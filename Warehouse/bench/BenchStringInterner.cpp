@@ -0,0 +1,137 @@
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// The replaced global allocation functions pair malloc with free
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+namespace
+{
+std::size_t allocations = 0;
+}  // namespace
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Measurement
+{
+    double milliseconds;
+    std::size_t allocations;
+    std::size_t matches;
+};
+
+template <typename Match>
+Measurement measure(const std::vector<warehouseInterface::IProductPtr> &products, Match match)
+{
+    const auto allocationsBefore = allocations;
+    const auto start = Clock::now();
+    std::size_t matches = 0;
+    for (const auto &product : products)
+        matches += static_cast<std::size_t>(match(*product));
+    return Measurement{millisecondsSince(start), allocations - allocationsBefore, matches};
+}
+
+void print(const char *label, const Measurement &measurement, std::size_t count)
+{
+    std::printf("  %-28s %9.2f ms  %9zu allocations (%.2f per item)  %zu matches\n",
+                label,
+                measurement.milliseconds,
+                measurement.allocations,
+                static_cast<double>(measurement.allocations) / static_cast<double>(count),
+                measurement.matches);
+}
+
+void run(std::size_t itemCount, std::size_t distinctNames)
+{
+    std::vector<std::string> names{};
+    for (std::size_t i = 0; i < distinctNames; ++i)
+        names.push_back("Warehouse product number " + std::to_string(i));
+
+    auto allocationsBefore = allocations;
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.reserve(itemCount);
+    for (std::size_t i = 0; i < itemCount; ++i)
+    {
+        if (i % 4 == 0)
+            products.push_back(std::make_unique<warehouse::GlassWare>(names[i % distinctNames], 1.0f));
+        else
+            products.push_back(std::make_unique<warehouse::IndustrialServerRack>(names[i % distinctNames], 0.5f));
+    }
+    std::printf("items %zu, distinct names %zu\n", itemCount, distinctNames);
+    std::printf("  construction                 %9zu allocations (%.2f per item)\n",
+                allocations - allocationsBefore,
+                static_cast<double>(allocations - allocationsBefore) / static_cast<double>(itemCount));
+
+    const std::string className = "GlassWare";
+    const std::string name = names[8];
+
+    // What every comparison did before: copy the class name and the product name
+    print("copied strings",
+          measure(products,
+                  [&](const warehouseInterface::IProduct &product) {
+                      const auto *base = dynamic_cast<const warehouse::BaseProduct *>(&product);
+                      return base && base->getClassName() == className && product.name() == name;
+                  }),
+          itemCount);
+
+    const warehouse::ProductQuery query{className, name};
+    print("ProductQuery::matches", measure(products, [&](const warehouseInterface::IProduct &product) { return query.matches(product); }), itemCount);
+
+    const auto symbols = query.symbols();
+    print("SymbolQuery::matches",
+          measure(products,
+                  [&](const warehouseInterface::IProduct &product) {
+                      const auto &base = static_cast<const warehouse::BaseProduct &>(product);
+                      return symbols.matches(base.classSymbol(), base.nameSymbol());
+                  }),
+          itemCount);
+
+    // One order line asked for from a warehouse holding the products
+    warehouse::Warehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<warehouse::SpecialDepartment>(1e9f));
+    warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(1e9f));
+    warehouse.newDelivery(std::move(products));
+    warehouse.newOrder("{\"order\": [{\"name\":\"" + names[1] + "\"}]}");
+
+    const std::string order = "{\"order\": [{\"class\":\"IndustrialServerRack\",\"name\":\"" + names[3] + "\"}]}";
+    constexpr std::size_t orders = 1000;
+    allocationsBefore = allocations;
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < orders; ++i)
+        warehouse.newOrder(order);
+    std::printf("  newOrder of one line         %9.4f ms  %9.2f allocations per order\n",
+                millisecondsSince(start) / static_cast<double>(orders),
+                static_cast<double>(allocations - allocationsBefore) / static_cast<double>(orders));
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t itemCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    run(itemCount, 1000);
+    return 0;
+}
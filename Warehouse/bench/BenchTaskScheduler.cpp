@@ -0,0 +1,63 @@
+#include <Warehouse/TaskScheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A small piece of work, about the cost of placing a few products
+ */
+std::uint64_t spin(std::uint64_t seed)
+{
+    for (int i = 0; i < 2000; ++i)
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed;
+}
+
+double runScheduler(warehouse::TaskScheduler &scheduler, std::size_t tasks)
+{
+    std::atomic<std::uint64_t> sink{0};
+    const auto start = Clock::now();
+    {
+        warehouse::TaskGroup group(scheduler);
+        for (std::size_t i = 0; i < tasks; ++i)
+            group.run([&sink, i]() { sink.fetch_xor(spin(i), std::memory_order_relaxed); });
+    }
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return sink.load() == 1 ? 0.0 : static_cast<double>(tasks) / seconds;
+}
+
+double runAsync(std::size_t tasks)
+{
+    std::atomic<std::uint64_t> sink{0};
+    const auto start = Clock::now();
+    std::vector<std::future<void>> futures{};
+    futures.reserve(tasks);
+    for (std::size_t i = 0; i < tasks; ++i)
+        futures.push_back(std::async(std::launch::async, [&sink, i]() { sink.fetch_xor(spin(i), std::memory_order_relaxed); }));
+    for (auto &future : futures)
+        future.get();
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return sink.load() == 1 ? 0.0 : static_cast<double>(tasks) / seconds;
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    std::printf("tasks completed per second, %zu tasks\n", tasks);
+    std::printf("  threads  TaskScheduler  std::async\n");
+    for (std::size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        warehouse::TaskScheduler scheduler(threads);
+        std::printf("  %7zu  %13.0f  %10.0f\n", threads, runScheduler(scheduler, tasks), runAsync(tasks));
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <Warehouse/Warehouse.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void fill(warehouse::Warehouse &warehouse, std::size_t itemCount, std::size_t distinctNames)
+{
+    warehouse::ProductFactory productFactory{};
+    warehouse.addDepartment(std::make_unique<warehouse::SpecialDepartment>(1e9f));
+    warehouse.addDepartment(std::make_unique<warehouse::OverSizeElectronicDepartment>(1e9f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.reserve(itemCount);
+    for (std::size_t i = 0; i < itemCount; ++i)
+    {
+        const auto name = "Product " + std::to_string(i % distinctNames);
+        const auto size = 0.1f + static_cast<float>(i % 97) * 0.37f;
+        if (i % 4 == 0)
+            products.emplace_back(productFactory.createProduct("GlassWare", name, size));
+        else
+            products.emplace_back(productFactory.createProduct("IndustrialServerRack", name, size));
+    }
+    warehouse.newDelivery(std::move(products));
+}
+
+void run(std::size_t itemCount, std::size_t distinctNames)
+{
+    warehouse::Warehouse source{};
+    fill(source, itemCount, distinctNames);
+
+    auto start = Clock::now();
+    const auto json = source.saveWarehouseState();
+    const double jsonSave = millisecondsSince(start);
+
+    start = Clock::now();
+    const auto binary = source.saveWarehouseStateBinary();
+    const double binarySave = millisecondsSince(start);
+
+    warehouse::Warehouse fromJson{};
+    start = Clock::now();
+    const bool jsonLoaded = fromJson.loadWarehouseState(json);
+    const double jsonLoad = millisecondsSince(start);
+
+    warehouse::Warehouse fromBinary{};
+    start = Clock::now();
+    const bool binaryLoaded = fromBinary.loadWarehouseStateBinary(binary);
+    const double binaryLoad = millisecondsSince(start);
+
+    const char *path = "BenchWarehouseSnapshot.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+    }
+    warehouse::Warehouse mapped{};
+    start = Clock::now();
+    const bool mappedOpened = mapped.openWarehouseStateSnapshot(path);
+    const auto report = mapped.getOccupancyReport();
+    const double mappedOpen = millisecondsSince(start);
+    std::remove(path);
+
+    const bool same = jsonLoaded && binaryLoaded && mappedOpened && fromBinary.saveWarehouseState() == json &&
+                      report == fromBinary.getOccupancyReport();
+    std::printf("%zu items, %zu distinct names%s\n", itemCount, distinctNames, same ? "" : " (ROUND TRIP MISMATCH)");
+    std::printf("  size  json %10zu B  binary %10zu B  ratio %5.1fx\n",
+                json.size(), binary.size(), static_cast<double>(json.size()) / static_cast<double>(binary.size()));
+    std::printf("  save  json %10.1f ms binary %10.1f ms speedup %5.1fx\n", jsonSave, binarySave, jsonSave / binarySave);
+    std::printf("  load  json %10.1f ms binary %10.1f ms speedup %5.1fx\n", jsonLoad, binaryLoad, jsonLoad / binaryLoad);
+    std::printf("  open  mapped snapshot and report occupancy %.3f ms\n", mappedOpen);
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const std::size_t itemCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    run(itemCount, 1000);
+    run(itemCount, itemCount);
+    return 0;
+}
@@ -3,19 +3,38 @@
 #include <PicoJson/picojson.h>
 
 #include <Interfaces/IDepartment.hpp>
-#include <deque>
+#include <Serialization/JsonSink.hpp>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
+
+#include "ItemIndex.hpp"
+#include "ItemStore.hpp"
+#include "MappedItems.hpp"
+#include "Occupancy.hpp"
+#include "ProductQuery.hpp"
+#include "SizeBucketIndex.hpp"
 
 namespace warehouse
 {
 
+/**
+ * @brief Order restrictions applied when items are taken from a department
+ */
+enum class AccessPolicy
+{
+    freeAccess,  ///< Any stored item can be taken, the oldest match wins
+    fifo,        ///< Only the oldest stored item can be taken
+    lifo         ///< Only the newest stored item can be taken
+};
+
 /**
  * @brief Base class for all warehouse departments
  *
  * Provides common functionality for all departments including:
  * - Product storage and retrieval
- * - Occupancy management
+ * - Occupancy management, held in fixed point (see Occupancy.hpp)
  * - Size restrictions
  * - Flag-based product filtering
  * - JSON serialization
@@ -23,11 +42,13 @@ namespace warehouse
 class BaseDepartment : public warehouseInterface::IDepartment
 {
 protected:
-    std::deque<warehouseInterface::IProductPtr> items_;     ///< Stored products
-    float occupancy_;                                       ///< Current occupancy
-    float maxOccupancy_;                                    ///< Maximum allowed occupancy
+    ItemStore items_;                                       ///< Stored products
+    OccupancyUnits occupancy_;                              ///< Current occupancy
+    OccupancyUnits maxOccupancyUnits_;                      ///< Maximum allowed occupancy in units, checked by canAddItem
+    float maxOccupancy_;                                    ///< Maximum allowed occupancy as configured
     float maxItemSize_;                                     ///< Maximum allowed item size
     warehouseInterface::ProductLabelFlags supportedFlags_;  ///< Supported product flags
+    AccessPolicy accessPolicy_;                             ///< Order restrictions of getItem
 
 public:
     /**
@@ -35,12 +56,33 @@ public:
      * @param maxOccupancy Maximum allowed occupancy
      * @param maxItemSize Maximum allowed item size
      * @param supportedFlags Supported product flags
+     * @param accessPolicy Order restrictions of getItem, free access departments maintain a lookup index
+     *                     built by the first request for a specific class or name
      */
-    BaseDepartment(float maxOccupancy, float maxItemSize, warehouseInterface::ProductLabelFlags supportedFlags) :
-            items_(), occupancy_(0.0f), maxOccupancy_(maxOccupancy), maxItemSize_(maxItemSize), supportedFlags_(supportedFlags)
+    BaseDepartment(float maxOccupancy,
+                   float maxItemSize,
+                   warehouseInterface::ProductLabelFlags supportedFlags,
+                   AccessPolicy accessPolicy = AccessPolicy::freeAccess) :
+            items_(),
+            occupancy_(0),
+            maxOccupancyUnits_(toOccupancyUnits(maxOccupancy)),
+            maxOccupancy_(maxOccupancy),
+            maxItemSize_(maxItemSize),
+            supportedFlags_(supportedFlags),
+            accessPolicy_(accessPolicy),
+            index_(),
+            indexed_(false),
+            removalsSinceCompaction_(0),
+            mapped_(),
+            mappedIndex_(),
+            mappedIndexed_(false),
+            sizeIndex_(),
+            sizeIndexed_(false),
+            mappedSizeIndex_(),
+            mappedSizeIndexed_(false)
     {}
 
-    float getOccupancy() const override { return occupancy_; }
+    float getOccupancy() const override { return fromOccupancyUnits(occupancy_); }
     float getMaxOccupancy() const override { return maxOccupancy_; }
     float getMaxItemSize() const override { return maxItemSize_; }
     warehouseInterface::ProductLabelFlags getSupportedFlags() const override { return supportedFlags_; }
@@ -50,28 +92,253 @@ public:
         picojson::object obj;
         obj["class"] = picojson::value(departmentName());
         obj["maxOccupancy"] = picojson::value(maxOccupancy_);
-        obj["occupancy"] = picojson::value(occupancy_);
+        obj["occupancy"] = picojson::value(getOccupancy());
         obj["items"] = picojson::value(serializedItems());
         return obj;
     }
 
-    warehouseInterface::DepartmentStateJson serialize() const override { return picojson::value(asJson()).serialize(); }
+    /**
+     * @brief Serve items of a mapped binary snapshot as the oldest items of the department
+     *
+     * Must be called before anything is stored. The department occupancy is summed from the
+     * snapshot item sizes, items are materialized only when they are taken.
+     *
+     * @param items Snapshot items of this department
+     */
+    void attachMappedItems(MappedItems items)
+    {
+        mapped_ = std::move(items);
+        occupancy_ = 0;
+        mapped_.forEach([this](MappedItems::Position position) { occupancy_ += toOccupancyUnits(mapped_.itemSize(position)); });
+        mappedIndex_.clear();
+        mappedIndexed_ = false;
+        mappedSizeIndex_.clear();
+        mappedSizeIndexed_ = false;
+    }
+
+    /**
+     * @brief Get the snapshot items still served from the mapping
+     */
+    const MappedItems &mappedItems() const { return mapped_; }
+
+    /**
+     * @brief Retrieve a product from the department
+     *
+     * Thin adapter over takeItem for callers holding a serialized product description.
+     *
+     * @param description JSON description of the product to find
+     * @return Pointer to the found product, or nullptr if not found
+     */
+    warehouseInterface::IProductPtr getItem(const warehouseInterface::ProductDescriptionJson &description) override
+    {
+        return takeItem(ProductQuery::parse(description));
+    }
+
+    /**
+     * @brief Take a product matching an already parsed query
+     *
+     * Free access departments return the oldest matching product, FIFO and LIFO departments only
+     * consider their oldest and newest product respectively.
+     *
+     * @param query Requested class, name and size range
+     * @return Pointer to the found product, or nullptr if not found
+     */
+    warehouseInterface::IProductPtr takeItem(const ProductQuery &query) { return takeItem(query, query.symbols()); }
+
+    /**
+     * @brief Take a product matching a query whose strings were already resolved
+     * @param query Requested class, name and size range
+     * @param symbols query.symbols(), resolved once by callers asking several departments
+     * @return Pointer to the found product, or nullptr if not found
+     */
+    warehouseInterface::IProductPtr takeItem(const ProductQuery &query, const SymbolQuery &symbols)
+    {
+        if (items_.empty() && mapped_.empty())
+            return nullptr;
+
+        // Mapped snapshot items are older than every stored item
+        switch (accessPolicy_)
+        {
+            case AccessPolicy::fifo:
+                if (!mapped_.empty())
+                    return matchesMapped(query, mapped_.front()) ? takeMappedAt(mapped_.front()) : nullptr;
+                return matchesStored(query, symbols, items_.front()) ? takeItemAt(items_.front()) : nullptr;
+            case AccessPolicy::lifo:
+                if (items_.empty())
+                    return matchesMapped(query, mapped_.back()) ? takeMappedAt(mapped_.back()) : nullptr;
+                return matchesStored(query, symbols, items_.back()) ? takeItemAt(items_.back()) : nullptr;
+            case AccessPolicy::freeAccess:
+                break;
+        }
+
+        if (query.hasSizeRange())
+            return takeOldestOfSize(query, symbols);
+
+        if (!query.className && !query.name)
+            return mapped_.empty() ? takeItemAt(items_.front()) : takeMappedAt(mapped_.front());
+
+        if (!mapped_.empty())
+        {
+            if (!mappedIndexed_)
+                buildMappedIndex();
+            // Snapshot strings are interned by the index build, which may come after the query was resolved
+            const auto position = mappedIndex_.takeOldest(symbols.matchesNothing ? query.symbols() : symbols,
+                                                           [this](ItemIndex::Position candidate) {
+                                                               return mapped_.isLive(candidate);
+                                                           });
+            if (position)
+                return takeMappedAt(*position);
+            if (items_.empty())
+                return nullptr;
+        }
+
+        if (!indexed_)
+            rebuildIndex();
+
+        const auto position = index_.takeOldest(symbols, [this](ItemIndex::Position candidate) { return items_.isLive(candidate); });
+        if (!position)
+            return nullptr;
+        return takeItemAt(*position);
+    }
+
+    warehouseInterface::DepartmentStateJson serialize() const override
+    {
+        JsonSink sink;
+        writeJson(sink);
+        return sink.release();
+    }
 
     picojson::array serializedItems() const override
     {
         picojson::array items;
-        for (const auto &item : items_)
-        {
-            if (item)
+        mapped_.forEach([this, &items](MappedItems::Position position) {
+            picojson::object obj;
+            obj["class"] = picojson::value(std::string(mapped_.className(position)));
+            obj["name"] = picojson::value(std::string(mapped_.name(position)));
+            obj["size"] = picojson::value(static_cast<double>(mapped_.itemSize(position)));
+            obj["flags"] = picojson::value(BaseProduct::flagsAsJson(mapped_.itemFlags(position)));
+            items.emplace_back(std::move(obj));
+        });
+        items_.forEach([this, &items](ItemStore::Position position) {
+            const auto item = items_.item(position);
+            if (item.classSymbol == noSymbol)
             {
                 picojson::value val;
-                picojson::parse(val, item->serialize());
-                items.push_back(val);
+                picojson::parse(val, item.product.serialize());
+                items.push_back(std::move(val));
+                return;
             }
-        }
+
+            picojson::object obj;
+            obj["class"] = picojson::value(std::string(items_.className(position)));
+            obj["name"] = picojson::value(std::string(items_.name(position)));
+            obj["size"] = picojson::value(static_cast<double>(item.size));
+            obj["flags"] = picojson::value(BaseProduct::flagsAsJson(item.flags));
+            items.emplace_back(std::move(obj));
+        });
         return items;
     }
 
+    /**
+     * @brief Write the serialized department (the same bytes as serialize()) to a JSON sink
+     * @param sink Destination sink
+     */
+    void writeJson(JsonSink &sink) const
+    {
+        sink.beginObject();
+        sink.key("class");
+        sink.value(departmentName());
+        sink.key("items");
+        sink.beginArray();
+        mapped_.forEach([this, &sink](MappedItems::Position position) {
+            BaseProduct::writeProductJson(sink,
+                                          mapped_.className(position),
+                                          mapped_.name(position),
+                                          mapped_.itemSize(position),
+                                          mapped_.itemFlags(position));
+        });
+        items_.forEach([this, &sink](ItemStore::Position position) { items_.writeJson(sink, position); });
+        sink.endArray();
+        sink.key("maxOccupancy");
+        sink.value(static_cast<double>(maxOccupancy_));
+        sink.key("occupancy");
+        sink.value(static_cast<double>(getOccupancy()));
+        sink.endObject();
+    }
+
+    /**
+     * @brief Visit the stored items in storage order, mapped snapshot items are not visited
+     * @param visit Callable taking a const ItemStore::Item &
+     */
+    template <typename Visitor>
+    void forEachItem(Visitor &&visit) const
+    {
+        items_.forEach([this, &visit](ItemStore::Position position) { visit(items_.item(position)); });
+    }
+
+    /**
+     * @brief Visit the stored items of a size range in storage order, mapped snapshot items are not visited
+     *
+     * Served from the size index, which is built by the first size query unless the department
+     * keeps it from the start.
+     *
+     * @param minSize Smallest item size, inclusive
+     * @param maxSize Largest item size, inclusive
+     * @param visit Callable taking a const ItemStore::Item &
+     */
+    template <typename Visitor>
+    void forEachItemOfSize(float minSize, float maxSize, Visitor &&visit)
+    {
+        if (!sizeIndexed_)
+            rebuildSizeIndex();
+        sizeIndex_.forEach(
+                minSize,
+                maxSize,
+                [this](SizeBucketIndex::Position position) { return items_.isLive(position); },
+                [this, minSize, maxSize](SizeBucketIndex::Position position) {
+                    const auto size = items_.itemSize(position);
+                    return size >= minSize && size <= maxSize;
+                },
+                [this, &visit](SizeBucketIndex::Position position) { visit(items_.item(position)); });
+    }
+
+    /**
+     * @brief Get the exact occupancy
+     */
+    OccupancyUnits occupancyUnits() const { return occupancy_; }
+
+    /**
+     * @brief Get the exact space left before the department is full
+     */
+    OccupancyUnits freeOccupancyUnits() const { return maxOccupancyUnits_ - occupancy_; }
+
+    /**
+     * @brief Check the size limits and free space for an item, the same check as canAddItem
+     * @param size Item size
+     */
+    bool hasRoomFor(float size) const
+    {
+        return size <= maxItemSize_ && toOccupancyUnits(size) <= maxOccupancyUnits_ - occupancy_;
+    }
+
+    /**
+     * @brief Recompute the occupancy from the stored sizes
+     *
+     * The running sum is exact, so this never changes it. Kept as a consistency check.
+     *
+     * @return The recomputed occupancy
+     */
+    float recalculateOccupancy()
+    {
+        OccupancyUnits occupancy = 0;
+        items_.forEach([this, &occupancy](ItemStore::Position position) { occupancy += toOccupancyUnits(items_.itemSize(position)); });
+        mapped_.forEach([this, &occupancy](MappedItems::Position position) {
+            occupancy += toOccupancyUnits(mapped_.itemSize(position));
+        });
+        occupancy_ = occupancy;
+        return getOccupancy();
+    }
+
 protected:
     /**
      * @brief Check if a product can be added to the department
@@ -89,14 +356,172 @@ protected:
     {
         if (!item)
             return false;
-        if (item->itemSize() > maxItemSize_)
-            return false;
-        if (occupancy_ + item->itemSize() > maxOccupancy_)
+        if (!hasRoomFor(item->itemSize()))
             return false;
         if ((static_cast<int>(item->itemFlags()) & static_cast<int>(supportedFlags_)) != static_cast<int>(item->itemFlags()))
             return false;
         return true;
     }
+
+    /**
+     * @brief Store a product that passed canAddItem
+     * @param item Product to store
+     */
+    void storeItem(warehouseInterface::IProductPtr item)
+    {
+        const auto position = items_.push(std::move(item));
+        occupancy_ += toOccupancyUnits(items_.itemSize(position));
+        if (indexed_)
+            index_.add(position, items_.classSymbol(position), items_.nameSymbol(position));
+        if (sizeIndexed_)
+            sizeIndex_.add(position, items_.itemSize(position));
+    }
+
+    /**
+     * @brief Maintain the size index from the first stored item instead of the first size query
+     */
+    void indexSizes()
+    {
+        if (!sizeIndexed_)
+            rebuildSizeIndex();
+    }
+
+private:
+    static constexpr std::size_t compactionThreshold = 64;  ///< Minimal removals before storage compaction
+
+    /**
+     * @brief Take the product at the given storage position and leave a tombstone in its slot
+     *
+     * Tombstones at both ends are dropped by the store right away, the remaining ones are compacted
+     * once there are more removals than live items since the last compaction, which keeps removal
+     * O(1) amortized.
+     */
+    warehouseInterface::IProductPtr takeItemAt(ItemStore::Position position)
+    {
+        occupancy_ -= toOccupancyUnits(items_.itemSize(position));
+        auto result = items_.take(position);
+        ++removalsSinceCompaction_;
+
+        if (items_.empty())
+        {
+            index_.clear();
+            sizeIndex_.clear();
+            removalsSinceCompaction_ = 0;
+        }
+        else if (removalsSinceCompaction_ >= compactionThreshold &&
+                 removalsSinceCompaction_ > items_.slots() - items_.tombstones())
+        {
+            items_.compact();
+            removalsSinceCompaction_ = 0;
+            if (indexed_)
+                rebuildIndex();
+            if (sizeIndexed_)
+                rebuildSizeIndex();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Index every live item, the index is kept up to date from then on
+     */
+    void rebuildIndex()
+    {
+        index_.clear();
+        items_.forEach([this](ItemStore::Position position) {
+            index_.add(position, items_.classSymbol(position), items_.nameSymbol(position));
+        });
+        indexed_ = true;
+    }
+
+    /**
+     * @brief Index the size of every live item, the index is kept up to date from then on
+     */
+    void rebuildSizeIndex()
+    {
+        sizeIndex_.clear();
+        items_.forEach([this](ItemStore::Position position) { sizeIndex_.add(position, items_.itemSize(position)); });
+        sizeIndexed_ = true;
+    }
+
+    /**
+     * @brief Take the oldest product of a free access department matching a query with a size range
+     */
+    warehouseInterface::IProductPtr takeOldestOfSize(const ProductQuery &query, const SymbolQuery &symbols)
+    {
+        if (!mapped_.empty())
+        {
+            if (!mappedSizeIndexed_)
+            {
+                mapped_.forEach([this](MappedItems::Position position) { mappedSizeIndex_.add(position, mapped_.itemSize(position)); });
+                mappedSizeIndexed_ = true;
+            }
+            const auto position = mappedSizeIndex_.findOldest(
+                    query.lowestSize(),
+                    query.highestSize(),
+                    [this](SizeBucketIndex::Position candidate) { return mapped_.isLive(candidate); },
+                    [this, &query](SizeBucketIndex::Position candidate) { return matchesMapped(query, candidate); });
+            if (position)
+                return takeMappedAt(*position);
+            if (items_.empty())
+                return nullptr;
+        }
+
+        if (!sizeIndexed_)
+            rebuildSizeIndex();
+        const auto position = sizeIndex_.findOldest(
+                query.lowestSize(),
+                query.highestSize(),
+                [this](SizeBucketIndex::Position candidate) { return items_.isLive(candidate); },
+                [this, &query, &symbols](SizeBucketIndex::Position candidate) { return matchesStored(query, symbols, candidate); });
+        if (!position)
+            return nullptr;
+        return takeItemAt(*position);
+    }
+
+    bool matchesStored(const ProductQuery &query, const SymbolQuery &symbols, ItemStore::Position position) const
+    {
+        return items_.matches(symbols, position) && query.matchesSize(items_.itemSize(position));
+    }
+
+    bool matchesMapped(const ProductQuery &query, MappedItems::Position position) const
+    {
+        return query.matches(mapped_.className(position), mapped_.name(position)) && query.matchesSize(mapped_.itemSize(position));
+    }
+
+    warehouseInterface::IProductPtr takeMappedAt(MappedItems::Position position)
+    {
+        occupancy_ -= toOccupancyUnits(mapped_.itemSize(position));
+        auto result = mapped_.take(position);
+        if (mapped_.empty())
+        {
+            mappedIndex_.clear();
+            mappedSizeIndex_.clear();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Index the live mapped items, mapped positions never move so the index stays valid
+     */
+    void buildMappedIndex()
+    {
+        auto &interner = StringInterner::global();
+        mapped_.forEach([this, &interner](MappedItems::Position position) {
+            mappedIndex_.add(position, interner.intern(mapped_.className(position)), interner.intern(mapped_.name(position)));
+        });
+        mappedIndexed_ = true;
+    }
+
+    ItemIndex index_;                      ///< Class/name lookup index, free access departments only
+    bool indexed_;                         ///< index_ is built, it is built by the first lookup by class or name
+    std::size_t removalsSinceCompaction_;  ///< Items taken since the last compaction
+    MappedItems mapped_;                   ///< Snapshot items preceding items_, see attachMappedItems()
+    ItemIndex mappedIndex_;                ///< Class/name lookup index of mapped_
+    bool mappedIndexed_;                   ///< mappedIndex_ is built
+    SizeBucketIndex sizeIndex_;            ///< Size lookup index, free access departments only
+    bool sizeIndexed_;                     ///< sizeIndex_ is built, by the first size query or by indexSizes()
+    SizeBucketIndex mappedSizeIndex_;      ///< Size lookup index of mapped_
+    bool mappedSizeIndexed_;               ///< mappedSizeIndex_ is built
 };
 
 }  // namespace warehouse
\ No newline at end of file
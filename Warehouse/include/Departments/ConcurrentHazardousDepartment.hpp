@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Interfaces/IDepartment.hpp>
+#include <Interfaces/ProductFlags.hpp>
+#include <MagicEnum/magic_enum.hpp>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include "LockFreeDepartment.hpp"
+
+using namespace magic_enum::bitwise_operators;
+
+namespace warehouse
+{
+
+/**
+ * @brief HazardousDepartment for ConcurrentWarehouse, items are added and taken without a lock
+ *
+ * Accepts the same products and serializes to the same state as HazardousDepartment, only the oldest
+ * item can be taken. The number of stored items is bounded by the capacity given at construction.
+ */
+class ConcurrentHazardousDepartment : public LockFreeDepartment<LockFreeItemQueue>
+{
+public:
+    static constexpr std::size_t defaultCapacity = 4096;  ///< Item capacity when none is given
+
+    ConcurrentHazardousDepartment(float maxOccupancy, std::size_t capacity = defaultCapacity) :
+            LockFreeDepartment(maxOccupancy,
+                               std::numeric_limits<float>::max(),
+                               warehouseInterface::ProductLabelFlags::fireHazardous | warehouseInterface::ProductLabelFlags::explosives,
+                               capacity)
+    {}
+
+    std::string departmentName() const override { return "HazardousDepartment"; }
+};
+
+}  // namespace warehouse
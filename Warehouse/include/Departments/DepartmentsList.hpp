@@ -1,5 +1,7 @@
 #pragma once
 #include <Departments/ColdRoomDepartment.hpp>
+#include <Departments/ConcurrentHazardousDepartment.hpp>
+#include <Departments/ConcurrentSpecialDepartment.hpp>
 #include <Departments/HazardousDepartment.hpp>
 #include <Departments/OverSizeElectronicDepartment.hpp>
 #include <Departments/SmallElectronicDepartment.hpp>
@@ -9,4 +11,6 @@ class ColdRoomDepartment;
 class SmallElectronicDepartment;
 class OverSizeElectronicDepartment;
 class HazardousDepartment;
-class SpecialDepartment;
\ No newline at end of file
+class SpecialDepartment;
+class ConcurrentHazardousDepartment;
+class ConcurrentSpecialDepartment;
\ No newline at end of file
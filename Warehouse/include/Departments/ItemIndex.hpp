@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <Products/StringInterner.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
+#include "ProductQuery.hpp"
+#include "Products/BaseProduct.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief Secondary lookup index over the items stored in a department
+ *
+ * Keeps the storage positions of items per class, per name and per (class, name) pair, keyed by
+ * interned symbols so neither adding nor looking up builds a string. Positions
+ * are appended in insertion order, so the front of every list is the oldest candidate. Removed
+ * items are not erased from the lists eagerly: the owner reports whether a position is still live
+ * and stale entries are dropped when they reach the front of a list.
+ */
+class ItemIndex
+{
+public:
+    using Position = std::size_t;
+
+    /**
+     * @brief Register a stored item
+     * @param position Storage position of the item, strictly increasing between calls
+     * @param item Stored product
+     */
+    void add(Position position, const warehouseInterface::IProduct &item)
+    {
+        // Only BaseProduct instances expose a class name that can be requested
+        if (const auto *base = dynamic_cast<const BaseProduct *>(&item))
+            add(position, base->classSymbol(), base->nameSymbol());
+        else
+            add(position, noSymbol, StringInterner::global().intern(item.name()));
+    }
+
+    /**
+     * @brief Register a stored item by its description
+     * @param position Storage position of the item, strictly increasing between calls
+     * @param className Product class, noSymbol if the class cannot be requested
+     * @param name Product name
+     */
+    void add(Position position, Symbol className, Symbol name)
+    {
+        byName_[name].push_back(position);
+        if (className != noSymbol)
+        {
+            byClassAndName_[pairKey(className, name)].push_back(position);
+            byClass_[className].push_back(position);
+        }
+    }
+
+    /**
+     * @brief Find the oldest live item matching the requested class and/or name
+     *
+     * The returned entry is consumed. Stale entries found at the front of the searched list are
+     * dropped on the way.
+     *
+     * @param query Requested class and/or name
+     * @param isLive Predicate telling whether a position still holds an item
+     * @return Position of the oldest match, std::nullopt if nothing matches
+     */
+    template <typename IsLive>
+    std::optional<Position> takeOldest(const SymbolQuery &query, IsLive isLive)
+    {
+        if (query.matchesNothing)
+            return std::nullopt;
+        if (query.className != noSymbol && query.name != noSymbol)
+            return takeFront(byClassAndName_, pairKey(query.className, query.name), isLive);
+        if (query.className != noSymbol)
+            return takeFront(byClass_, query.className, isLive);
+        if (query.name != noSymbol)
+            return takeFront(byName_, query.name, isLive);
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Drop every entry
+     */
+    void clear()
+    {
+        byClass_.clear();
+        byName_.clear();
+        byClassAndName_.clear();
+    }
+
+private:
+    template <typename Key>
+    using PositionsMap = std::unordered_map<Key, std::deque<Position>>;
+
+    static std::uint64_t pairKey(Symbol className, Symbol name)
+    {
+        return (static_cast<std::uint64_t>(className) << 32) | name;
+    }
+
+    template <typename Key, typename IsLive>
+    static std::optional<Position> takeFront(PositionsMap<Key> &map, Key key, IsLive isLive)
+    {
+        auto found = map.find(key);
+        if (found == map.end())
+            return std::nullopt;
+
+        auto &positions = found->second;
+        while (!positions.empty() && !isLive(positions.front()))
+        {
+            positions.pop_front();
+        }
+
+        std::optional<Position> result{};
+        if (!positions.empty())
+        {
+            result = positions.front();
+            positions.pop_front();
+        }
+        if (positions.empty())
+            map.erase(found);
+        return result;
+    }
+
+    PositionsMap<Symbol> byClass_{};                ///< Positions per product class
+    PositionsMap<Symbol> byName_{};                 ///< Positions per product name
+    PositionsMap<std::uint64_t> byClassAndName_{};  ///< Positions per (class, name) pair
+};
+
+}  // namespace warehouse
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <Products/BaseProduct.hpp>
+#include <Products/StringInterner.hpp>
+#include <Serialization/JsonSink.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "ProductQuery.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief Column storage of the items of a department
+ *
+ * Items are kept as parallel arrays of sizes, flags, class and name symbols, so lookups,
+ * scans, serialization and occupancy sums walk contiguous memory without calling into the
+ * products. The products themselves are only touched when they leave the store, which hands out
+ * the stored object.
+ *
+ * Items are addressed by storage positions that grow with every stored item. Taking an item
+ * leaves a tombstone, tombstones at both ends are dropped right away and the rest are removed by
+ * compact(), which renumbers the positions.
+ */
+class ItemStore
+{
+public:
+    using Position = std::size_t;
+
+    /**
+     * @brief Description of a stored item
+     */
+    struct Item
+    {
+        Symbol classSymbol;                           ///< Product class, noSymbol if the product is not a BaseProduct
+        Symbol nameSymbol;                            ///< Product name
+        float size;                                   ///< Product size
+        warehouseInterface::ProductLabelFlags flags;  ///< Product flags
+        const warehouseInterface::IProduct &product;  ///< Stored product
+    };
+
+    ItemStore() :
+            sizes_(),
+            flags_(),
+            classSymbols_(),
+            nameSymbols_(),
+            products_(),
+            basePosition_(0),
+            frontPosition_(0),
+            tombstones_(0),
+            types_()
+    {}
+
+    bool empty() const { return frontPosition_ == endPosition(); }
+
+    /**
+     * @brief Position of the oldest item, valid if the store is not empty
+     */
+    Position front() const { return frontPosition_; }
+
+    /**
+     * @brief Position of the newest item, valid if the store is not empty
+     */
+    Position back() const { return endPosition() - 1; }
+
+    /**
+     * @brief Number of positions between the oldest and the newest item, tombstones included
+     */
+    std::size_t slots() const { return endPosition() - frontPosition_; }
+
+    /**
+     * @brief Number of taken items still occupying a position
+     */
+    std::size_t tombstones() const { return tombstones_; }
+
+    bool isLive(Position position) const
+    {
+        return position >= frontPosition_ && position < endPosition() && classSymbols_[position - basePosition_] != takenSymbol;
+    }
+
+    /**
+     * @brief Get the class symbol of a live item, noSymbol if the product is not a BaseProduct
+     */
+    Symbol classSymbol(Position position) const { return classSymbols_[position - basePosition_]; }
+    Symbol nameSymbol(Position position) const { return nameSymbols_[position - basePosition_]; }
+    std::string_view className(Position position) const { return StringInterner::global().view(classSymbol(position)); }
+    std::string_view name(Position position) const { return StringInterner::global().view(nameSymbol(position)); }
+    float itemSize(Position position) const { return sizes_[position - basePosition_]; }
+
+    warehouseInterface::ProductLabelFlags itemFlags(Position position) const
+    {
+        return static_cast<warehouseInterface::ProductLabelFlags>(flags_[position - basePosition_]);
+    }
+
+    Item item(Position position) const
+    {
+        const auto slot = position - basePosition_;
+        return Item{classSymbols_[slot], nameSymbols_[slot], sizes_[slot], itemFlags(position), *products_[slot]};
+    }
+
+    /**
+     * @brief Check a live item against a resolved query, with the semantics of ProductQuery::matches()
+     */
+    bool matches(const SymbolQuery &query, Position position) const
+    {
+        const auto slot = position - basePosition_;
+        return query.matches(classSymbols_[slot], nameSymbols_[slot]);
+    }
+
+    /**
+     * @brief Store a product as the newest item
+     * @param product Product to store
+     * @return Position of the stored item
+     */
+    Position push(warehouseInterface::IProductPtr product)
+    {
+        const auto position = endPosition();
+        sizes_.push_back(product->itemSize());
+        flags_.push_back(static_cast<std::uint8_t>(product->itemFlags()));
+        const auto *base = dynamic_cast<const BaseProduct *>(product.get());
+        classSymbols_.push_back(base ? classOf(*base) : noSymbol);
+        nameSymbols_.push_back(base ? base->nameSymbol() : StringInterner::global().intern(product->name()));
+        products_.push_back(std::move(product));
+        return position;
+    }
+
+    /**
+     * @brief Take a live item
+     * @param position Live position
+     * @return The stored product
+     */
+    warehouseInterface::IProductPtr take(Position position)
+    {
+        const auto slot = position - basePosition_;
+        auto product = std::move(products_[slot]);
+        classSymbols_[slot] = takenSymbol;
+        sizes_[slot] = 0.0f;
+        ++tombstones_;
+        trim();
+        return product;
+    }
+
+    /**
+     * @brief Sum the sizes of all live items, taken items have a zero size
+     */
+    double occupancy() const
+    {
+        double sum = 0.0;
+        for (std::size_t slot = frontPosition_ - basePosition_; slot < sizes_.size(); ++slot)
+            sum += static_cast<double>(sizes_[slot]);
+        return sum;
+    }
+
+    /**
+     * @brief Visit the live positions from the oldest to the newest
+     * @param visit Callable taking a Position
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        for (std::size_t slot = frontPosition_ - basePosition_; slot < classSymbols_.size(); ++slot)
+        {
+            if (classSymbols_[slot] != takenSymbol)
+                visit(basePosition_ + slot);
+        }
+    }
+
+    /**
+     * @brief Write a live item in the format of IProduct::serialize()
+     */
+    void writeJson(JsonSink &sink, Position position) const
+    {
+        if (classSymbol(position) != noSymbol)
+            BaseProduct::writeProductJson(sink, className(position), name(position), itemSize(position), itemFlags(position));
+        else
+            sink.rawValue(products_[position - basePosition_]->serialize());
+    }
+
+    /**
+     * @brief Drop all tombstones, live items keep their order and get consecutive positions from front()
+     */
+    void compact()
+    {
+        std::size_t kept = 0;
+        for (std::size_t slot = frontPosition_ - basePosition_; slot < classSymbols_.size(); ++slot)
+        {
+            if (classSymbols_[slot] == takenSymbol)
+                continue;
+
+            sizes_[kept] = sizes_[slot];
+            flags_[kept] = flags_[slot];
+            classSymbols_[kept] = classSymbols_[slot];
+            nameSymbols_[kept] = nameSymbols_[slot];
+            products_[kept] = std::move(products_[slot]);
+            ++kept;
+        }
+        resizeColumns(kept);
+        basePosition_ = frontPosition_;
+        tombstones_ = 0;
+    }
+
+private:
+    static constexpr Symbol takenSymbol = 0xFFFFFFFF;  ///< Class symbol of a tombstone
+    static constexpr std::size_t minReclaim = 64;      ///< Minimal dropped front slots before they are released
+
+    Position endPosition() const { return basePosition_ + classSymbols_.size(); }
+
+    /**
+     * @brief Get the class symbol of a product
+     *
+     * Products with a type id are resolved through the type table, the others arrive in few types
+     * so their types are scanned linearly.
+     */
+    Symbol classOf(const BaseProduct &product)
+    {
+        if (product.typeId() != ProductTypeId::unknown)
+            return productTypeSymbol(product.typeId());
+
+        const auto &type = typeid(product);
+        for (const auto &[knownType, symbol] : types_)
+        {
+            if (*knownType == type)
+                return symbol;
+        }
+        types_.emplace_back(&type, product.classSymbol());
+        return types_.back().second;
+    }
+
+    /**
+     * @brief Drop tombstones at both ends and release front slots once they outweigh the live ones
+     */
+    void trim()
+    {
+        while (endPosition() > frontPosition_ && classSymbols_.back() == takenSymbol)
+        {
+            resizeColumns(classSymbols_.size() - 1);
+            --tombstones_;
+        }
+        while (frontPosition_ < endPosition() && classSymbols_[frontPosition_ - basePosition_] == takenSymbol)
+        {
+            ++frontPosition_;
+            --tombstones_;
+        }
+
+        if (empty())
+        {
+            resizeColumns(0);
+            basePosition_ = frontPosition_;
+        }
+        else if (frontPosition_ - basePosition_ >= minReclaim && frontPosition_ - basePosition_ > slots())
+        {
+            const auto dropped = static_cast<std::ptrdiff_t>(frontPosition_ - basePosition_);
+            sizes_.erase(sizes_.begin(), sizes_.begin() + dropped);
+            flags_.erase(flags_.begin(), flags_.begin() + dropped);
+            classSymbols_.erase(classSymbols_.begin(), classSymbols_.begin() + dropped);
+            nameSymbols_.erase(nameSymbols_.begin(), nameSymbols_.begin() + dropped);
+            products_.erase(products_.begin(), products_.begin() + dropped);
+            basePosition_ = frontPosition_;
+        }
+    }
+
+    void resizeColumns(std::size_t size)
+    {
+        sizes_.resize(size);
+        flags_.resize(size);
+        classSymbols_.resize(size);
+        nameSymbols_.resize(size);
+        products_.resize(size);
+    }
+
+    std::vector<float> sizes_;                                     ///< Item sizes, 0 for tombstones
+    std::vector<std::uint8_t> flags_;                              ///< Item flags
+    std::vector<Symbol> classSymbols_;                             ///< Class symbols, noSymbol for foreign products, takenSymbol for tombstones
+    std::vector<Symbol> nameSymbols_;                              ///< Name symbols
+    std::vector<warehouseInterface::IProductPtr> products_;        ///< Stored products, nullptr for tombstones
+    Position basePosition_;                                        ///< Position of the first column entry
+    Position frontPosition_;                                       ///< Position of the oldest live item
+    std::size_t tombstones_;                                       ///< Taken items between front() and back()
+    std::vector<std::pair<const std::type_info *, Symbol>> types_;  ///< Class symbol per product type
+};
+
+}  // namespace warehouse
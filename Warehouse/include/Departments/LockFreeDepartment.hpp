@@ -0,0 +1,204 @@
+#pragma once
+
+#include <PicoJson/picojson.h>
+
+#include <Interfaces/IDepartment.hpp>
+#include <Serialization/JsonSink.hpp>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+#include "LockFreeItemQueue.hpp"
+#include "LockFreeItemStack.hpp"
+#include "Occupancy.hpp"
+#include "ProductQuery.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief Department whose items can be added and taken by many threads at once without a lock
+ *
+ * ConcurrentWarehouse calls tryAddItem() and takeItem() of such departments without locking them.
+ * The remaining IDepartment calls are meant for a quiescent department.
+ */
+class ConcurrentDepartment : public warehouseInterface::IDepartment
+{
+public:
+    /**
+     * @brief Store a product if the department accepts it
+     * @param item Product to store, moved from only if it was stored
+     * @return true if the product was stored
+     */
+    virtual bool tryAddItem(warehouseInterface::IProductPtr &item) = 0;
+
+    /**
+     * @brief Take a product matching a query whose strings were already resolved
+     * @param query Requested class and name, queries with a size range match nothing
+     * @param symbols query.symbols()
+     * @return Pointer to the found product, or nullptr if not found
+     */
+    virtual warehouseInterface::IProductPtr takeItem(const ProductQuery &query, const SymbolQuery &symbols) = 0;
+
+    /**
+     * @brief Get the exact occupancy, getOccupancy() rounded to a float
+     */
+    virtual OccupancyUnits occupancyUnits() const = 0;
+};
+
+/**
+ * @brief Lock-free department storing its items in a LockFreeItemQueue (FIFO) or LockFreeItemStack (LIFO)
+ *
+ * Occupancy is an atomic count of occupancy units reserved with a CAS before an item is stored, so concurrent deliveries never
+ * overfill the department. Only the item at the front of the container can be taken, as in a
+ * BaseDepartment with AccessPolicy::fifo or AccessPolicy::lifo, and the serialized form is the one of
+ * BaseDepartment. Serialization requires that no other thread uses the department.
+ *
+ * @tparam Container LockFreeItemQueue or LockFreeItemStack
+ */
+template <typename Container>
+class LockFreeDepartment : public ConcurrentDepartment
+{
+public:
+    /**
+     * @brief Construct a new Lock Free Department
+     * @param maxOccupancy Maximum allowed occupancy
+     * @param maxItemSize Maximum allowed item size
+     * @param supportedFlags Supported product flags
+     * @param capacity Maximum number of stored items
+     */
+    LockFreeDepartment(float maxOccupancy, float maxItemSize, warehouseInterface::ProductLabelFlags supportedFlags, std::size_t capacity) :
+            items_(capacity),
+            occupancy_(0),
+            maxOccupancyUnits_(toOccupancyUnits(maxOccupancy)),
+            maxOccupancy_(maxOccupancy),
+            maxItemSize_(maxItemSize),
+            supportedFlags_(supportedFlags)
+    {}
+
+    bool addItem(warehouseInterface::IProductPtr item) override { return tryAddItem(item); }
+
+    bool tryAddItem(warehouseInterface::IProductPtr &item) override
+    {
+        if (!item)
+            return false;
+        const float size = item->itemSize();
+        if (size > maxItemSize_)
+            return false;
+        if ((static_cast<int>(item->itemFlags()) & static_cast<int>(supportedFlags_)) != static_cast<int>(item->itemFlags()))
+            return false;
+        const auto units = toOccupancyUnits(size);
+        if (!reserve(units))
+            return false;
+
+        const auto *base = dynamic_cast<const BaseProduct *>(item.get());
+        const auto classSymbol = base ? base->classSymbol() : noSymbol;
+        const auto nameSymbol = base ? base->nameSymbol() : StringInterner::global().intern(item->name());
+        if (items_.push(item, classSymbol, nameSymbol))
+            return true;
+        release(units);
+        return false;
+    }
+
+    warehouseInterface::IProductPtr getItem(const warehouseInterface::ProductDescriptionJson &description) override
+    {
+        const auto query = ProductQuery::parse(description);
+        return takeItem(query, query.symbols());
+    }
+
+    warehouseInterface::IProductPtr takeItem(const ProductQuery &query, const SymbolQuery &symbols) override
+    {
+        // The queue only sees the symbols of its oldest item, item sizes cannot be matched without taking it
+        if (query.hasSizeRange())
+            return nullptr;
+        auto item = items_.popIf([&symbols](Symbol classSymbol, Symbol nameSymbol) { return symbols.matches(classSymbol, nameSymbol); });
+        if (item)
+            release(toOccupancyUnits(item->itemSize()));
+        return item;
+    }
+
+    OccupancyUnits occupancyUnits() const override { return occupancy_.load(std::memory_order_relaxed); }
+    float getOccupancy() const override { return fromOccupancyUnits(occupancyUnits()); }
+    float getMaxOccupancy() const override { return maxOccupancy_; }
+    float getMaxItemSize() const override { return maxItemSize_; }
+    warehouseInterface::ProductLabelFlags getSupportedFlags() const override { return supportedFlags_; }
+
+    picojson::object asJson() const override
+    {
+        picojson::object obj;
+        obj["class"] = picojson::value(departmentName());
+        obj["maxOccupancy"] = picojson::value(maxOccupancy_);
+        obj["occupancy"] = picojson::value(getOccupancy());
+        obj["items"] = picojson::value(serializedItems());
+        return obj;
+    }
+
+    warehouseInterface::DepartmentStateJson serialize() const override
+    {
+        JsonSink sink;
+        writeJson(sink);
+        return sink.release();
+    }
+
+    picojson::array serializedItems() const override
+    {
+        picojson::array items;
+        items_.forEach([&items](const warehouseInterface::IProduct &product, Symbol, Symbol) {
+            picojson::value val;
+            picojson::parse(val, product.serialize());
+            items.push_back(std::move(val));
+        });
+        return items;
+    }
+
+    /**
+     * @brief Write the serialized department (the same bytes as serialize()) to a JSON sink
+     * @param sink Destination sink
+     */
+    void writeJson(JsonSink &sink) const
+    {
+        sink.beginObject();
+        sink.key("class");
+        sink.value(departmentName());
+        sink.key("items");
+        sink.beginArray();
+        items_.forEach([&sink](const warehouseInterface::IProduct &product, Symbol, Symbol) {
+            if (const auto *base = dynamic_cast<const BaseProduct *>(&product))
+                base->writeJson(sink);
+            else
+                sink.rawValue(product.serialize());
+        });
+        sink.endArray();
+        sink.key("maxOccupancy");
+        sink.value(static_cast<double>(maxOccupancy_));
+        sink.key("occupancy");
+        sink.value(static_cast<double>(getOccupancy()));
+        sink.endObject();
+    }
+
+private:
+    /**
+     * @brief Add an item size to the occupancy unless it would exceed maxOccupancyUnits_
+     */
+    bool reserve(OccupancyUnits units)
+    {
+        auto occupancy = occupancy_.load(std::memory_order_relaxed);
+        do
+        {
+            if (units > maxOccupancyUnits_ - occupancy)
+                return false;
+        } while (!occupancy_.compare_exchange_weak(occupancy, occupancy + units, std::memory_order_relaxed));
+        return true;
+    }
+
+    void release(OccupancyUnits units) { occupancy_.fetch_sub(units, std::memory_order_relaxed); }
+
+    Container items_;                                       ///< Stored products
+    std::atomic<OccupancyUnits> occupancy_;                 ///< Current occupancy, reserved before an item is stored
+    const OccupancyUnits maxOccupancyUnits_;                ///< Maximum allowed occupancy in units
+    const float maxOccupancy_;                              ///< Maximum allowed occupancy as configured
+    const float maxItemSize_;                               ///< Maximum allowed item size
+    const warehouseInterface::ProductLabelFlags supportedFlags_;  ///< Supported product flags
+};
+
+}  // namespace warehouse
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Products/StringInterner.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief Bounded multi-producer multi-consumer FIFO of products
+ *
+ * A ring of cells with per-cell sequence numbers: a producer claims the cell at the enqueue position
+ * with one CAS and publishes it by bumping the cell sequence, a consumer does the same at the dequeue
+ * position. The class and name symbols of every item live in atomics of its cell, so a conditional
+ * pop checks the oldest item without owning it and gives up if it does not match.
+ *
+ * Items can only be visited while no other thread uses the queue.
+ */
+class LockFreeItemQueue
+{
+public:
+    /**
+     * @brief Create an empty queue
+     * @param capacity Maximum number of items, rounded up to a power of two
+     */
+    explicit LockFreeItemQueue(std::size_t capacity) :
+            mask_(roundUp(capacity) - 1), cells_(new Cell[mask_ + 1]), enqueuePosition_(0), dequeuePosition_(0)
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    LockFreeItemQueue(const LockFreeItemQueue &) = delete;
+    LockFreeItemQueue &operator=(const LockFreeItemQueue &) = delete;
+
+    ~LockFreeItemQueue()
+    {
+        while (popIf([](Symbol, Symbol) { return true; }))
+        {
+        }
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    bool empty() const
+    {
+        return dequeuePosition_.load(std::memory_order_acquire) == enqueuePosition_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Append a product as the newest item
+     * @param product Product to store, moved from only if it was stored
+     * @param classSymbol Class of the product
+     * @param nameSymbol Name of the product
+     * @return false if the queue is full
+     */
+    bool push(warehouseInterface::IProductPtr &product, Symbol classSymbol, Symbol nameSymbol)
+    {
+        auto position = enqueuePosition_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        for (;;)
+        {
+            cell = &cells_[position & mask_];
+            const auto lag = static_cast<std::intptr_t>(cell->sequence.load(std::memory_order_acquire) - position);
+            if (lag == 0)
+            {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (lag < 0)
+                return false;
+            else
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+        }
+
+        // Pairs with the fence of a popIf() still reading the previous item of the cell
+        std::atomic_thread_fence(std::memory_order_release);
+        cell->classSymbol.store(classSymbol, std::memory_order_relaxed);
+        cell->nameSymbol.store(nameSymbol, std::memory_order_relaxed);
+        cell->product = product.release();
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest item if it matches
+     * @param matches Callable taking the class and name symbols of the oldest item
+     * @return The oldest product, nullptr if the queue is empty or the oldest item does not match
+     */
+    template <typename Predicate>
+    warehouseInterface::IProductPtr popIf(Predicate &&matches)
+    {
+        auto position = dequeuePosition_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto &cell = cells_[position & mask_];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::intptr_t>(sequence - (position + 1));
+            if (lag < 0)
+                return nullptr;
+            if (lag > 0)
+            {
+                position = dequeuePosition_.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            const auto classSymbol = cell.classSymbol.load(std::memory_order_relaxed);
+            const auto nameSymbol = cell.nameSymbol.load(std::memory_order_relaxed);
+            if (!matches(classSymbol, nameSymbol))
+            {
+                // The symbols belong to the item at position unless the cell was taken and refilled meanwhile
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (cell.sequence.load(std::memory_order_relaxed) == sequence)
+                    return nullptr;
+                position = dequeuePosition_.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (dequeuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                warehouseInterface::IProductPtr product(cell.product);
+                cell.product = nullptr;
+                cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                return product;
+            }
+        }
+    }
+
+    /**
+     * @brief Visit the items from the oldest to the newest, only while no other thread uses the queue
+     * @param visit Callable taking the product, its class symbol and its name symbol
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        const auto end = enqueuePosition_.load(std::memory_order_acquire);
+        for (auto position = dequeuePosition_.load(std::memory_order_acquire); position != end; ++position)
+        {
+            const auto &cell = cells_[position & mask_];
+            visit(*cell.product,
+                  cell.classSymbol.load(std::memory_order_relaxed),
+                  cell.nameSymbol.load(std::memory_order_relaxed));
+        }
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{0};      ///< position while free, position + 1 once filled
+        std::atomic<Symbol> classSymbol{noSymbol};  ///< Class of the stored product
+        std::atomic<Symbol> nameSymbol{noSymbol};   ///< Name of the stored product
+        warehouseInterface::IProduct *product = nullptr;  ///< Stored product, owned by the queue while filled
+    };
+
+    static std::size_t roundUp(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        return size;
+    }
+
+    const std::size_t mask_;                      ///< Cell count - 1
+    std::unique_ptr<Cell[]> cells_;               ///< Ring of cells
+    alignas(64) std::atomic<std::size_t> enqueuePosition_;  ///< Position of the next push, on a cache line of its own
+    alignas(64) std::atomic<std::size_t> dequeuePosition_;  ///< Position of the next pop
+};
+
+}  // namespace warehouse
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Products/StringInterner.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief Bounded multi-producer multi-consumer LIFO of products
+ *
+ * A Treiber stack over a fixed array of nodes, unused nodes are kept on a second Treiber stack. Both
+ * heads pack a node index with a tag bumped by every change, so a head that was popped and pushed
+ * back between a load and a CAS never passes for unchanged. The class and name symbols of every
+ * item live in atomics of its node, so a conditional pop checks the newest item without owning it
+ * and gives up if it does not match.
+ *
+ * Items can only be visited while no other thread uses the stack.
+ */
+class LockFreeItemStack
+{
+public:
+    /**
+     * @brief Create an empty stack
+     * @param capacity Maximum number of items
+     */
+    explicit LockFreeItemStack(std::size_t capacity) :
+            nodes_(new Node[capacity ? capacity : 1]), capacity_(capacity ? capacity : 1), top_(0), free_(0)
+    {
+        for (std::size_t i = capacity_; i > 0; --i)
+            pushNode(free_, static_cast<std::uint32_t>(i));
+    }
+
+    LockFreeItemStack(const LockFreeItemStack &) = delete;
+    LockFreeItemStack &operator=(const LockFreeItemStack &) = delete;
+
+    ~LockFreeItemStack()
+    {
+        while (popIf([](Symbol, Symbol) { return true; }))
+        {
+        }
+    }
+
+    std::size_t capacity() const { return capacity_; }
+
+    bool empty() const { return indexOf(top_.load(std::memory_order_acquire)) == 0; }
+
+    /**
+     * @brief Store a product as the newest item
+     * @param product Product to store, moved from only if it was stored
+     * @param classSymbol Class of the product
+     * @param nameSymbol Name of the product
+     * @return false if the stack is full
+     */
+    bool push(warehouseInterface::IProductPtr &product, Symbol classSymbol, Symbol nameSymbol)
+    {
+        const auto index = popNode(free_);
+        if (!index)
+            return false;
+
+        auto &node = nodeAt(index);
+        // Pairs with the fence of a popIf() still reading the previous item of the node
+        std::atomic_thread_fence(std::memory_order_release);
+        node.classSymbol.store(classSymbol, std::memory_order_relaxed);
+        node.nameSymbol.store(nameSymbol, std::memory_order_relaxed);
+        node.product = product.release();
+        pushNode(top_, index);
+        return true;
+    }
+
+    /**
+     * @brief Take the newest item if it matches
+     * @param matches Callable taking the class and name symbols of the newest item
+     * @return The newest product, nullptr if the stack is empty or the newest item does not match
+     */
+    template <typename Predicate>
+    warehouseInterface::IProductPtr popIf(Predicate &&matches)
+    {
+        auto top = top_.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const auto index = indexOf(top);
+            if (!index)
+                return nullptr;
+
+            auto &node = nodeAt(index);
+            const auto next = node.next.load(std::memory_order_relaxed);
+            const auto classSymbol = node.classSymbol.load(std::memory_order_relaxed);
+            const auto nameSymbol = node.nameSymbol.load(std::memory_order_relaxed);
+            if (!matches(classSymbol, nameSymbol))
+            {
+                // The symbols belong to the newest item unless the top changed meanwhile
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const auto current = top_.load(std::memory_order_acquire);
+                if (current == top)
+                    return nullptr;
+                top = current;
+                continue;
+            }
+
+            if (top_.compare_exchange_weak(top, pack(next, tagOf(top) + 1), std::memory_order_acquire, std::memory_order_acquire))
+            {
+                warehouseInterface::IProductPtr product(node.product);
+                node.product = nullptr;
+                pushNode(free_, index);
+                return product;
+            }
+        }
+    }
+
+    /**
+     * @brief Visit the items from the oldest to the newest, only while no other thread uses the stack
+     * @param visit Callable taking the product, its class symbol and its name symbol
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        std::vector<std::uint32_t> indices{};
+        for (auto index = indexOf(top_.load(std::memory_order_acquire)); index; index = nodeAt(index).next.load(std::memory_order_relaxed))
+            indices.push_back(index);
+        for (auto it = indices.rbegin(); it != indices.rend(); ++it)
+        {
+            const auto &node = nodeAt(*it);
+            visit(*node.product, node.classSymbol.load(std::memory_order_relaxed), node.nameSymbol.load(std::memory_order_relaxed));
+        }
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<std::uint32_t> next{0};         ///< Index of the node below, 0 at the bottom
+        std::atomic<Symbol> classSymbol{noSymbol};  ///< Class of the stored product
+        std::atomic<Symbol> nameSymbol{noSymbol};   ///< Name of the stored product
+        warehouseInterface::IProduct *product = nullptr;  ///< Stored product, owned by the stack while on top_
+    };
+
+    /// Heads hold the tag in the high half and the 1-based node index in the low half, index 0 is the empty list
+    static std::uint64_t pack(std::uint32_t index, std::uint32_t tag) { return static_cast<std::uint64_t>(tag) << 32 | index; }
+    static std::uint32_t indexOf(std::uint64_t head) { return static_cast<std::uint32_t>(head & 0xFFFFFFFFu); }
+    static std::uint32_t tagOf(std::uint64_t head) { return static_cast<std::uint32_t>(head >> 32); }
+
+    Node &nodeAt(std::uint32_t index) const { return nodes_[index - 1]; }
+
+    void pushNode(std::atomic<std::uint64_t> &head, std::uint32_t index)
+    {
+        auto &node = nodeAt(index);
+        auto current = head.load(std::memory_order_relaxed);
+        do
+        {
+            node.next.store(indexOf(current), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(current, pack(index, tagOf(current) + 1), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    std::uint32_t popNode(std::atomic<std::uint64_t> &head)
+    {
+        auto current = head.load(std::memory_order_acquire);
+        while (indexOf(current))
+        {
+            const auto next = nodeAt(indexOf(current)).next.load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(current, pack(next, tagOf(current) + 1), std::memory_order_acquire, std::memory_order_acquire))
+                return indexOf(current);
+        }
+        return 0;
+    }
+
+    std::unique_ptr<Node[]> nodes_;                  ///< Every node, items and free ones
+    const std::size_t capacity_;                     ///< Node count
+    alignas(64) std::atomic<std::uint64_t> top_;     ///< Newest item
+    alignas(64) std::atomic<std::uint64_t> free_;    ///< Unused nodes
+};
+
+}  // namespace warehouse
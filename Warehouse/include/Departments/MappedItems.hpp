@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <Serialization/MappedSnapshot.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace warehouse
+{
+
+/**
+ * @brief Items of one department served straight from a mapped binary snapshot
+ *
+ * Items are addressed by their position within the department, 0 being the oldest. Taken
+ * positions are remembered in a set, so attaching a snapshot costs the same regardless of its
+ * item count.
+ */
+class MappedItems
+{
+public:
+    using Position = std::size_t;
+
+    MappedItems() : snapshot_(), first_(0), count_(0), front_(0), back_(0), taken_() {}
+
+    /**
+     * @brief Construct a view over the items of a snapshot department
+     * @param snapshot Opened snapshot
+     * @param department Index of the department record
+     */
+    MappedItems(std::shared_ptr<const MappedSnapshot> snapshot, std::size_t department) :
+            snapshot_(std::move(snapshot)), first_(0), count_(0), front_(0), back_(0), taken_()
+    {
+        const auto record = snapshot_->reader().department(department);
+        first_ = record.firstItem;
+        count_ = record.itemCount;
+        back_ = count_;
+    }
+
+    /**
+     * @brief Number of positions, taken ones included
+     */
+    std::size_t size() const { return count_; }
+
+    bool empty() const { return front_ == back_; }
+    Position front() const { return front_; }
+    Position back() const { return back_ - 1; }
+    bool isLive(Position position) const { return position >= front_ && position < back_ && !taken_.count(position); }
+
+    std::string_view className(Position position) const
+    {
+        const auto &reader = snapshot_->reader();
+        return reader.productClass(reader.itemClass(first_ + position));
+    }
+
+    std::string_view name(Position position) const
+    {
+        const auto &reader = snapshot_->reader();
+        return reader.string(reader.itemName(first_ + position));
+    }
+
+    float itemSize(Position position) const { return snapshot_->reader().itemSize(first_ + position); }
+
+    warehouseInterface::ProductLabelFlags itemFlags(Position position) const
+    {
+        return static_cast<warehouseInterface::ProductLabelFlags>(snapshot_->reader().itemFlags(first_ + position));
+    }
+
+    /**
+     * @brief Take a live item and create its product
+     * @param position Live position
+     * @return The materialized product, nullptr if its class is unknown
+     */
+    warehouseInterface::IProductPtr take(Position position)
+    {
+        auto product = snapshot_->materialize(std::string(className(position)), std::string(name(position)), itemSize(position));
+
+        taken_.insert(position);
+        while (front_ < back_ && taken_.count(front_))
+            taken_.erase(front_++);
+        while (back_ > front_ && taken_.count(back_ - 1))
+            taken_.erase(--back_);
+        return product;
+    }
+
+    /**
+     * @brief Visit the live positions from the oldest to the newest
+     * @param visit Callable taking a Position
+     */
+    template <typename Visitor>
+    void forEach(Visitor &&visit) const
+    {
+        for (Position position = front_; position < back_; ++position)
+        {
+            if (!taken_.count(position))
+                visit(position);
+        }
+    }
+
+private:
+    std::shared_ptr<const MappedSnapshot> snapshot_;  ///< Snapshot holding the items, nullptr if nothing is mapped
+    std::size_t first_;                               ///< Index of the first item in the snapshot item columns
+    std::size_t count_;                               ///< Number of items in the snapshot
+    Position front_;                                  ///< Oldest position that may be live
+    Position back_;                                   ///< One past the newest position that may be live
+    std::unordered_set<Position> taken_;              ///< Taken positions between front_ and back_
+};
+
+}  // namespace warehouse
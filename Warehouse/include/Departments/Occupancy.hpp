@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace warehouse
+{
+
+/**
+ * @brief Department occupancy in fixed point, one unit is a millionth of an item size
+ *
+ * Departments add and subtract item sizes as integers, so taking an item cancels its store exactly
+ * and the occupancy never drifts. Floats are only used at the IDepartment and JSON boundary.
+ */
+using OccupancyUnits = std::int64_t;
+
+constexpr OccupancyUnits occupancyUnitsPerSize = 1000000;                  ///< Units of an item of size 1
+constexpr OccupancyUnits occupancyUnitsLimit = OccupancyUnits{1} << 62;  ///< Conversions saturate here, a sum of two never overflows
+
+/**
+ * @brief Convert a size to occupancy units, rounding to the nearest unit
+ * @param size Item size or occupancy limit, huge values saturate and NaN counts as zero
+ */
+inline OccupancyUnits toOccupancyUnits(float size)
+{
+    const double units = static_cast<double>(size) * static_cast<double>(occupancyUnitsPerSize);
+    if (std::isnan(units))
+        return 0;
+    if (units >= static_cast<double>(occupancyUnitsLimit))
+        return occupancyUnitsLimit;
+    if (units <= -static_cast<double>(occupancyUnitsLimit))
+        return -occupancyUnitsLimit;
+    return std::llround(units);
+}
+
+/**
+ * @brief Convert occupancy units back to a size for reports and interfaces
+ */
+inline float fromOccupancyUnits(OccupancyUnits units)
+{
+    return static_cast<float>(static_cast<double>(units) / static_cast<double>(occupancyUnitsPerSize));
+}
+
+}  // namespace warehouse
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <PicoJson/picojson.h>
+
+#include <Interfaces/Aliases.hpp>
+#include <Interfaces/IProduct.hpp>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Products/BaseProduct.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief ProductQuery with its strings resolved to interned symbols
+ *
+ * Resolving only looks strings up: a requested class or name that was never interned cannot match
+ * any product, which is reported by matchesNothing instead of adding the string.
+ */
+struct SymbolQuery
+{
+    Symbol className = noSymbol;  ///< Requested class, noSymbol to match any class
+    Symbol name = noSymbol;       ///< Requested name, noSymbol to match any name
+    bool matchesNothing = false;  ///< A requested string is unknown
+
+    /**
+     * @brief Check a product described by symbols against the query
+     * @param itemClass Product class, noSymbol if the class cannot be requested
+     * @param itemName Product name
+     */
+    bool matches(Symbol itemClass, Symbol itemName) const
+    {
+        return !matchesNothing && (className == noSymbol || className == itemClass) && (name == noSymbol || name == itemName);
+    }
+};
+
+/**
+ * @brief Typed form of a requested product description
+ *
+ * A product is looked up by its class, its name and an inclusive range of item sizes. A missing
+ * field matches any value. Orders are parsed into queries once and then handed to every department.
+ */
+struct ProductQuery
+{
+    std::optional<std::string> className{};  ///< Requested product class
+    std::optional<std::string> name{};       ///< Requested product name
+    std::optional<float> minSize{};          ///< Smallest requested item size
+    std::optional<float> maxSize{};          ///< Largest requested item size
+
+    /**
+     * @brief Build a query from an already parsed product description
+     * @param description JSON object with optional "class" and "name" string fields and optional
+     *                    "minSize" and "maxSize" number fields
+     * @return Query matching the description
+     */
+    static ProductQuery fromJson(const picojson::object &description)
+    {
+        ProductQuery query{};
+        const auto classIt = description.find("class");
+        if (classIt != description.end())
+            query.className = classIt->second.get<std::string>();
+        const auto nameIt = description.find("name");
+        if (nameIt != description.end())
+            query.name = nameIt->second.get<std::string>();
+        const auto minSizeIt = description.find("minSize");
+        if (minSizeIt != description.end())
+            query.minSize = static_cast<float>(minSizeIt->second.get<double>());
+        const auto maxSizeIt = description.find("maxSize");
+        if (maxSizeIt != description.end())
+            query.maxSize = static_cast<float>(maxSizeIt->second.get<double>());
+        return query;
+    }
+
+    /**
+     * @brief Parse a serialized product description
+     * @param description Serialized JSON object with the fields read by fromJson()
+     * @return Query matching the description
+     */
+    static ProductQuery parse(const warehouseInterface::ProductDescriptionJson &description)
+    {
+        picojson::value val;
+        picojson::parse(val, description);
+        return fromJson(val.get<picojson::object>());
+    }
+
+    /**
+     * @brief Resolve the requested strings to symbols of StringInterner::global()
+     */
+    SymbolQuery symbols() const
+    {
+        SymbolQuery query{};
+        const auto &interner = StringInterner::global();
+        if (className)
+        {
+            query.className = interner.find(*className);
+            query.matchesNothing = query.className == noSymbol;
+        }
+        if (name)
+        {
+            query.name = interner.find(*name);
+            query.matchesNothing = query.matchesNothing || query.name == noSymbol;
+        }
+        return query;
+    }
+
+    /**
+     * @brief Check whether the query restricts the item size
+     */
+    bool hasSizeRange() const { return minSize || maxSize; }
+
+    /**
+     * @brief Smallest size matching the query
+     */
+    float lowestSize() const { return minSize ? *minSize : std::numeric_limits<float>::lowest(); }
+
+    /**
+     * @brief Largest size matching the query
+     */
+    float highestSize() const { return maxSize ? *maxSize : std::numeric_limits<float>::max(); }
+
+    /**
+     * @brief Check an item size against the requested range
+     */
+    bool matchesSize(float size) const { return (!minSize || size >= *minSize) && (!maxSize || size <= *maxSize); }
+
+    /**
+     * @brief Check a single product against the query
+     * @param item Product to check
+     * @return true if the product class (for BaseProduct instances only), name and size match
+     */
+    bool matches(const warehouseInterface::IProduct &item) const
+    {
+        if (!matchesSize(item.itemSize()))
+            return false;
+        const auto *base = dynamic_cast<const BaseProduct *>(&item);
+        if (className && (!base || *className != base->classNameView()))
+            return false;
+        if (!name)
+            return true;
+        return base ? *name == base->nameView() : *name == item.name();
+    }
+
+    /**
+     * @brief Check a product description against the class and name of the query
+     * @param itemClass Product class
+     * @param itemName Product name
+     * @return true if the class and name match
+     */
+    bool matches(std::string_view itemClass, std::string_view itemName) const
+    {
+        return (!className || *className == itemClass) && (!name || *name == itemName);
+    }
+};
+
+}  // namespace warehouse
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Secondary index of the items stored in a department by item size
+ *
+ * Items are kept in log-scale buckets, one per power of two, and every bucket lists its positions
+ * in insertion order, so the front of a bucket is its oldest item. A size range only visits the
+ * buckets it overlaps. As in ItemIndex, removed items are not erased eagerly: the owner reports
+ * whether a position is still live and stale entries are dropped when they reach the front.
+ */
+class SizeBucketIndex
+{
+public:
+    using Position = std::size_t;
+
+    static constexpr int minExponent = -32;         ///< Sizes below 2^minExponent share the first bucket
+    static constexpr std::size_t bucketsCount = 64;  ///< Sizes from 2^(minExponent + 63) on share the last bucket
+
+    SizeBucketIndex() : buckets_() {}
+
+    /**
+     * @brief Register a stored item
+     * @param position Storage position of the item, strictly increasing between calls
+     * @param size Item size
+     */
+    void add(Position position, float size)
+    {
+        if (buckets_.empty())
+            buckets_.resize(bucketsCount);
+        buckets_[bucketOf(size)].positions.push_back(position);
+    }
+
+    /**
+     * @brief Drop every entry
+     */
+    void clear() { buckets_.clear(); }
+
+    /**
+     * @brief Find the oldest live item of a size range accepted by a predicate
+     * @param minSize Smallest size, inclusive
+     * @param maxSize Largest size, inclusive
+     * @param isLive Predicate telling whether a position still holds an item
+     * @param accept Predicate checking a live position, including its exact size
+     * @return Position of the oldest accepted item, std::nullopt if there is none
+     */
+    template <typename IsLive, typename Accept>
+    std::optional<Position> findOldest(float minSize, float maxSize, IsLive isLive, Accept accept)
+    {
+        std::optional<Position> oldest{};
+        if (buckets_.empty() || minSize > maxSize)
+            return oldest;
+
+        for (auto bucket = bucketOf(minSize); bucket <= bucketOf(maxSize); ++bucket)
+        {
+            auto &entries = buckets_[bucket];
+            dropStale(entries, isLive);
+            for (auto i = entries.head; i < entries.positions.size(); ++i)
+            {
+                const auto position = entries.positions[i];
+                if (oldest && position >= *oldest)
+                    break;
+                if (isLive(position) && accept(position))
+                {
+                    oldest = position;
+                    break;
+                }
+            }
+        }
+        return oldest;
+    }
+
+    /**
+     * @brief Visit the live items of a size range accepted by a predicate, from the oldest to the newest
+     * @param minSize Smallest size, inclusive
+     * @param maxSize Largest size, inclusive
+     * @param isLive Predicate telling whether a position still holds an item
+     * @param accept Predicate checking a live position, including its exact size
+     * @param visit Callable taking a Position
+     */
+    template <typename IsLive, typename Accept, typename Visitor>
+    void forEach(float minSize, float maxSize, IsLive isLive, Accept accept, Visitor &&visit) const
+    {
+        if (buckets_.empty() || minSize > maxSize)
+            return;
+
+        std::vector<Position> found{};
+        for (auto bucket = bucketOf(minSize); bucket <= bucketOf(maxSize); ++bucket)
+        {
+            const auto &entries = buckets_[bucket];
+            for (auto i = entries.head; i < entries.positions.size(); ++i)
+            {
+                if (isLive(entries.positions[i]) && accept(entries.positions[i]))
+                    found.push_back(entries.positions[i]);
+            }
+        }
+        std::sort(found.begin(), found.end());
+        for (const auto position : found)
+            visit(position);
+    }
+
+    /**
+     * @brief Get the bucket of a size, zero, negative and NaN sizes go to the first bucket
+     */
+    static std::size_t bucketOf(float size)
+    {
+        if (!(size > 0.0f))
+            return 0;
+        if (std::isinf(size))
+            return bucketsCount - 1;
+        int exponent = 0;
+        std::frexp(size, &exponent);
+        return static_cast<std::size_t>(std::clamp(exponent - minExponent, 0, static_cast<int>(bucketsCount) - 1));
+    }
+
+private:
+    static constexpr std::size_t compactionThreshold = 32;  ///< Minimal dropped entries before a bucket is compacted
+
+    /**
+     * @brief Positions of one bucket, positions before head were dropped
+     */
+    struct Bucket
+    {
+        std::vector<Position> positions{};
+        std::size_t head = 0;
+    };
+
+    template <typename IsLive>
+    static void dropStale(Bucket &entries, IsLive &isLive)
+    {
+        while (entries.head < entries.positions.size() && !isLive(entries.positions[entries.head]))
+            ++entries.head;
+        if (entries.head >= compactionThreshold && entries.head * 2 > entries.positions.size())
+        {
+            entries.positions.erase(entries.positions.begin(), entries.positions.begin() + static_cast<std::ptrdiff_t>(entries.head));
+            entries.head = 0;
+        }
+    }
+
+    std::vector<Bucket> buckets_;  ///< Buckets by size, empty until the first item is added
+};
+
+}  // namespace warehouse
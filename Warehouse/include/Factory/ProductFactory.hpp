@@ -1,48 +1,107 @@
 #pragma once
+#include <Factory/ProductRegistry.hpp>
 #include <Interfaces/IProduct.hpp>
 #include <Products/BasicProduct.hpp>
+#include <Products/ProductPool.hpp>
+#include <Products/ProductTypes.hpp>
 #include <Products/ProductsList.hpp>
+#include <array>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace warehouse
 {
+/**
+ * @brief One product of a batch passed to ProductFactory::createProducts()
+ */
+struct ProductSpec
+{
+    std::string className;  ///< Product class
+    std::string name;       ///< Product name
+    float size;             ///< Product size
+};
+
+/**
+ * @brief Process-wide product allocation settings
+ */
+struct ProductFactoryOptions
+{
+    bool pooledAllocation = false;  ///< Allocate products from ProductPool slabs instead of the global operator new
+};
+
+/**
+ * @brief Creates products through ProductRegistry::global(), constructing a factory costs nothing
+ */
 class ProductFactory
 {
 public:
+    /**
+     * @brief Apply allocation settings, possible only before the first product is created
+     * @param options Settings for every product of the process
+     * @return true if the settings are in effect
+     */
+    static bool configure(const ProductFactoryOptions &options)
+    {
+        return ProductPool::global().configure(options.pooledAllocation);
+    }
+
     warehouseInterface::IProductPtr createProduct(const std::string &className, const std::string &name, const float size) const
     {
-        if (className == "IndustrialServerRack")
-        {
-            return std::make_unique<IndustrialServerRack>(name, size);
-        }
-        else if (className == "GlassWare")
-        {
-            return std::make_unique<GlassWare>(name, size);
-        }
-        else if (className == "ExplosiveBarrel")
-        {
-            return std::make_unique<ExplosiveBarrel>(name, size);
-        }
-        else if (className == "ElectronicParts")
-        {
-            return std::make_unique<ElectronicParts>(name, size);
-        }
-        else if (className == "AstronautsIceCream")
+        return ProductRegistry::global().create(className, name, size);
+    }
+
+    /**
+     * @brief Create a product of a class known by its type id
+     * @return The product, nullptr for ProductTypeId::unknown
+     */
+    warehouseInterface::IProductPtr createProduct(ProductTypeId type, const std::string &name, const float size) const
+    {
+        return ProductRegistry::global().create(type, name, size);
+    }
+
+    /**
+     * @brief Create a batch of products, ready to be passed to Warehouse::newDelivery()
+     *
+     * With pooled allocation the blocks of the whole batch are reserved up front, so the products
+     * are placed in a few slabs instead of being allocated one by one.
+     * @param specs Products to create
+     * @return One product per spec in the same order, nullptr for specs of unknown classes
+     */
+    std::vector<warehouseInterface::IProductPtr> createProducts(const std::vector<ProductSpec> &specs) const
+    {
+        const auto &registry = ProductRegistry::global();
+        std::vector<ProductTypeId> types{};
+        types.reserve(specs.size());
+        std::array<std::size_t, productTypeNames.size()> counts{};
+        for (const auto &spec : specs)
         {
-            return std::make_unique<AstronautsIceCream>(name, size);
+            types.push_back(productTypeId(spec.className));
+            ++counts[static_cast<std::size_t>(types.back())];
         }
-        else if (className == "AcetoneBarrel")
+
+        std::map<std::size_t, std::size_t> blocks{};
+        for (std::size_t i = 1; i < counts.size(); ++i)
         {
-            return std::make_unique<AcetoneBarrel>(name, size);
+            if (counts[i])
+                blocks[ProductPool::blockSizeOf(ProductRegistry::objectSize(static_cast<ProductTypeId>(i)))] += counts[i];
         }
-        else if (className == "TV")
+        for (const auto &[blockSize, count] : blocks)
+            ProductPool::global().reserve(count, blockSize);
+
+        std::vector<warehouseInterface::IProductPtr> products{};
+        products.reserve(specs.size());
+        for (std::size_t i = 0; i < specs.size(); ++i)
         {
-            return std::make_unique<TV>(name, size);
+            const auto &spec = specs[i];
+            if (types[i] != ProductTypeId::unknown)
+                products.push_back(registry.create(types[i], spec.name, spec.size));
+            else
+                products.push_back(registry.create(spec.className, spec.name, spec.size));
         }
-
-        return nullptr;
+        return products;
     }
 };
 
-}  // namespace warehouse
\ No newline at end of file
+}  // namespace warehouse
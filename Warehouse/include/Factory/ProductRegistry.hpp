@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <Products/ProductTypes.hpp>
+#include <Products/ProductsList.hpp>
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+namespace warehouse
+{
+
+/**
+ * @brief Class name to product constructor registry
+ *
+ * The classes of WAREHOUSE_PRODUCT_TYPES are resolved through their compile-time perfect hash
+ * without locking, classes registered at runtime are looked up under a shared lock only when the
+ * name is not one of them.
+ */
+class ProductRegistry
+{
+public:
+    /// Product constructor taking the product name and size
+    using Creator = std::function<warehouseInterface::IProductPtr(const std::string &name, float size)>;
+
+    ProductRegistry() : builtins_(), mutex_(), registered_()
+    {
+#define WAREHOUSE_REGISTER_PRODUCT(className)                                                                   \
+    static_assert(className::productType == ProductTypeId::className, #className " has the wrong type id");     \
+    builtins_[static_cast<std::size_t>(ProductTypeId::className)] = [](const std::string &name, float size) { \
+        return warehouseInterface::IProductPtr(std::make_unique<className>(name, size));                       \
+    };
+        WAREHOUSE_PRODUCT_TYPES(WAREHOUSE_REGISTER_PRODUCT)
+#undef WAREHOUSE_REGISTER_PRODUCT
+    }
+
+    ProductRegistry(const ProductRegistry &) = delete;
+    ProductRegistry &operator=(const ProductRegistry &) = delete;
+
+    /**
+     * @brief Get the registry shared by the whole process
+     */
+    static ProductRegistry &global()
+    {
+        static ProductRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Register a product class that is not in WAREHOUSE_PRODUCT_TYPES
+     * @param className Class name written to serialized products
+     * @param creator Constructor of the class
+     * @return false if the class name is already registered
+     */
+    bool registerProduct(const std::string &className, Creator creator)
+    {
+        if (className.empty() || !creator || productTypeId(className) != ProductTypeId::unknown)
+            return false;
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        return registered_.emplace(className, std::move(creator)).second;
+    }
+
+    /**
+     * @brief Find the constructor of a class
+     * @param className Product class name
+     * @return The constructor, valid for the lifetime of the registry, nullptr for unknown classes
+     */
+    const Creator *find(std::string_view className) const
+    {
+        const auto type = productTypeId(className);
+        if (type != ProductTypeId::unknown)
+            return &builtins_[static_cast<std::size_t>(type)];
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const auto found = registered_.find(className);
+        return found == registered_.end() ? nullptr : &found->second;
+    }
+
+    /**
+     * @brief Create a product
+     * @param className Product class name
+     * @param name Product name
+     * @param size Product size
+     * @return The product, nullptr if the class is unknown
+     */
+    warehouseInterface::IProductPtr create(std::string_view className, const std::string &name, float size) const
+    {
+        const auto *creator = find(className);
+        return creator ? (*creator)(name, size) : nullptr;
+    }
+
+    /**
+     * @brief Create a product of a class known by its type id
+     * @return The product, nullptr for ProductTypeId::unknown
+     */
+    warehouseInterface::IProductPtr create(ProductTypeId type, const std::string &name, float size) const
+    {
+        if (type == ProductTypeId::unknown)
+            return nullptr;
+        return builtins_[static_cast<std::size_t>(type)](name, size);
+    }
+
+    /**
+     * @brief Size of the objects of a class known by its type id, 0 for ProductTypeId::unknown
+     */
+    static constexpr std::size_t objectSize(ProductTypeId type)
+    {
+        constexpr std::array sizes{
+                std::size_t{0},
+#define WAREHOUSE_PRODUCT_SIZE(className) sizeof(className),
+                WAREHOUSE_PRODUCT_TYPES(WAREHOUSE_PRODUCT_SIZE)
+#undef WAREHOUSE_PRODUCT_SIZE
+        };
+        return sizes[static_cast<std::size_t>(type)];
+    }
+
+private:
+    std::array<Creator, productTypeNames.size()> builtins_;    ///< Constructors indexed by type id
+    mutable std::shared_mutex mutex_;                          ///< Guards registered_
+    std::map<std::string, Creator, std::less<>> registered_;   ///< Constructors registered at runtime
+};
+
+}  // namespace warehouse
@@ -14,13 +14,16 @@ namespace warehouse
 class AcetoneBarrel : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::AcetoneBarrel;  ///< Type id of the class
+
     AcetoneBarrel(const std::string &name, float size) :
             BaseProduct(
                     name,
                     size,
-                    warehouseInterface::ProductLabelFlags::fireHazardous | warehouseInterface::ProductLabelFlags::esdSensitive)
+                    warehouseInterface::ProductLabelFlags::fireHazardous | warehouseInterface::ProductLabelFlags::esdSensitive,
+                    productType)
     {}
 
-    std::string getClassName() const override { return "AcetoneBarrel"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
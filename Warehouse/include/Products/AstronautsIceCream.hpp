@@ -14,12 +14,15 @@ namespace warehouse
 class AstronautsIceCream : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::AstronautsIceCream;  ///< Type id of the class
+
     AstronautsIceCream(const std::string &name, float size) :
             BaseProduct(name,
                         size,
-                        warehouseInterface::ProductLabelFlags::keepFrozen | warehouseInterface::ProductLabelFlags::keepDry)
+                        warehouseInterface::ProductLabelFlags::keepFrozen | warehouseInterface::ProductLabelFlags::keepDry,
+                        productType)
     {}
 
-    std::string getClassName() const override { return "AstronautsIceCream"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
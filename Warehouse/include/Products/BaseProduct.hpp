@@ -3,7 +3,15 @@
 #include <PicoJson/picojson.h>
 
 #include <Interfaces/IProduct.hpp>
+#include <Products/ProductPool.hpp>
+#include <Products/ProductTypes.hpp>
+#include <Products/StringInterner.hpp>
+#include <Serialization/JsonSink.hpp>
+#include <array>
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace warehouse
 {
@@ -12,16 +20,17 @@ namespace warehouse
  * @brief Base class for all warehouse products
  *
  * Provides common functionality for all products including:
- * - Name and size management
+ * - Name and size management, names are interned in StringInterner::global()
  * - Product flags handling
  * - JSON serialization
  */
 class BaseProduct : public warehouseInterface::IProduct
 {
 protected:
-    std::string _name;                             ///< Product name
+    Symbol _name;                                  ///< Interned product name
     float _size;                                   ///< Product size
     warehouseInterface::ProductLabelFlags _flags;  ///< Product flags
+    ProductTypeId _typeId;                         ///< Type id of the product class
 
 public:
     /**
@@ -29,51 +38,123 @@ public:
      * @param name Product name
      * @param size Product size
      * @param flags Product flags
+     * @param typeId Type id of the product class, ProductTypeId::unknown for classes outside WAREHOUSE_PRODUCT_TYPES
      */
-    BaseProduct(const std::string &name, float size, warehouseInterface::ProductLabelFlags flags) :
-            _name(name), _size(size), _flags(flags)
+    BaseProduct(const std::string &name,
+                float size,
+                warehouseInterface::ProductLabelFlags flags,
+                ProductTypeId typeId = ProductTypeId::unknown) :
+            _name(StringInterner::global().intern(name)), _size(size), _flags(flags), _typeId(typeId)
     {}
 
-    std::string name() const override { return _name; }
+    /**
+     * @brief Products are allocated through ProductPool::global(), the virtual destructor hands the size of the most derived class to delete
+     */
+    static void *operator new(std::size_t size) { return ProductPool::global().allocate(size); }
+    static void operator delete(void *memory, std::size_t size) noexcept { ProductPool::global().deallocate(memory, size); }
+
+    std::string name() const override { return std::string(nameView()); }
     float itemSize() const override { return _size; }
     warehouseInterface::ProductLabelFlags itemFlags() const override { return _flags; }
 
     picojson::object asJson() const override
     {
         picojson::object obj;
-        obj["name"] = picojson::value(_name);
+        obj["name"] = picojson::value(std::string(nameView()));
         obj["size"] = picojson::value(_size);
-
-        picojson::array flagsArray;
-        const auto flags = static_cast<int>(_flags);
-
-        // Check each flag and add to array if set
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::fragile))
-            flagsArray.push_back(picojson::value("fragile"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::keepDry))
-            flagsArray.push_back(picojson::value("keepDry"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::keepFrozen))
-            flagsArray.push_back(picojson::value("keepFrozen"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::esdSensitive))
-            flagsArray.push_back(picojson::value("esdSensitive"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::fireHazardous))
-            flagsArray.push_back(picojson::value("fireHazardous"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::explosives))
-            flagsArray.push_back(picojson::value("explosives"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::handleWithCare))
-            flagsArray.push_back(picojson::value("handleWithCare"));
-        if (flags & static_cast<int>(warehouseInterface::ProductLabelFlags::upWard))
-            flagsArray.push_back(picojson::value("upWard"));
-
-        obj["flags"] = picojson::value(flagsArray);
+        obj["flags"] = picojson::value(flagsAsJson(_flags));
         return obj;
     }
 
     warehouseInterface::ProductDescriptionJson serialize() const override
     {
-        picojson::object obj = asJson();
-        obj["class"] = picojson::value(getClassName());
-        return picojson::value(obj).serialize();
+        JsonSink sink;
+        writeJson(sink);
+        return sink.release();
+    }
+
+    /**
+     * @brief Write the serialized product (the same bytes as serialize()) to a JSON sink
+     * @param sink Destination sink
+     */
+    void writeJson(JsonSink &sink) const { writeProductJson(sink, classNameView(), nameView(), _size, _flags); }
+
+    /**
+     * @brief Get the product name without copying it
+     */
+    std::string_view nameView() const { return StringInterner::global().view(_name); }
+
+    Symbol nameSymbol() const { return _name; }
+
+    /**
+     * @brief Get the type id of the product class, comparing it needs neither RTTI nor the class name
+     */
+    ProductTypeId typeId() const { return _typeId; }
+
+    /**
+     * @brief Get the interned class name
+     *
+     * Products with a type id take it from a table interned once, the others intern getClassName()
+     * unless they override this.
+     */
+    virtual Symbol classSymbol() const
+    {
+        if (_typeId != ProductTypeId::unknown)
+            return productTypeSymbol(_typeId);
+        return StringInterner::global().intern(getClassName());
+    }
+
+    /**
+     * @brief Get the class name without copying it
+     */
+    std::string_view classNameView() const { return StringInterner::global().view(classSymbol()); }
+
+    /**
+     * @brief Write a product known only by its description, in the format of serialize()
+     * @param sink Destination sink
+     * @param className Product class name
+     * @param name Product name
+     * @param size Product size
+     * @param flags Product flags
+     */
+    static void writeProductJson(JsonSink &sink,
+                                 std::string_view className,
+                                 std::string_view name,
+                                 float size,
+                                 warehouseInterface::ProductLabelFlags flags)
+    {
+        sink.beginObject();
+        sink.key("class");
+        sink.value(className);
+        sink.key("flags");
+        sink.beginArray();
+        for (const auto &[flag, flagName] : flagNames)
+        {
+            if (static_cast<int>(flags) & static_cast<int>(flag))
+                sink.value(flagName);
+        }
+        sink.endArray();
+        sink.key("name");
+        sink.value(name);
+        sink.key("size");
+        sink.value(static_cast<double>(size));
+        sink.endObject();
+    }
+
+    /**
+     * @brief Get the "flags" array of a serialized product
+     * @param flags Product flags
+     * @return Flag names in serialization order
+     */
+    static picojson::array flagsAsJson(warehouseInterface::ProductLabelFlags flags)
+    {
+        picojson::array flagsArray;
+        for (const auto &[flag, flagName] : flagNames)
+        {
+            if (static_cast<int>(flags) & static_cast<int>(flag))
+                flagsArray.push_back(picojson::value(flagName));
+        }
+        return flagsArray;
     }
 
     /**
@@ -81,6 +162,19 @@ public:
      * @return String containing the product's class name
      */
     virtual std::string getClassName() const = 0;
+
+protected:
+    /// Serialized flag names in the order they appear in the "flags" array
+    static constexpr std::array<std::pair<warehouseInterface::ProductLabelFlags, const char *>, 8> flagNames{{
+            {warehouseInterface::ProductLabelFlags::fragile, "fragile"},
+            {warehouseInterface::ProductLabelFlags::keepDry, "keepDry"},
+            {warehouseInterface::ProductLabelFlags::keepFrozen, "keepFrozen"},
+            {warehouseInterface::ProductLabelFlags::esdSensitive, "esdSensitive"},
+            {warehouseInterface::ProductLabelFlags::fireHazardous, "fireHazardous"},
+            {warehouseInterface::ProductLabelFlags::explosives, "explosives"},
+            {warehouseInterface::ProductLabelFlags::handleWithCare, "handleWithCare"},
+            {warehouseInterface::ProductLabelFlags::upWard, "upWard"},
+    }};
 };
 
 }  // namespace warehouse
\ No newline at end of file
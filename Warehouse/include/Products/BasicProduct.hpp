@@ -14,6 +14,12 @@ public:
 
 protected:
     std::string getClassName() const override { return "BasicProduct"; }
+
+    Symbol classSymbol() const override
+    {
+        static const Symbol symbol = StringInterner::global().intern("BasicProduct");
+        return symbol;
+    }
 };
 
 }  // namespace warehouse
\ No newline at end of file
@@ -14,12 +14,15 @@ namespace warehouse
 class ElectronicParts : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::ElectronicParts;  ///< Type id of the class
+
     ElectronicParts(const std::string &name, float size) :
             BaseProduct(name,
                         size,
-                        warehouseInterface::ProductLabelFlags::keepDry | warehouseInterface::ProductLabelFlags::esdSensitive)
+                        warehouseInterface::ProductLabelFlags::keepDry | warehouseInterface::ProductLabelFlags::esdSensitive,
+                        productType)
     {}
 
-    std::string getClassName() const override { return "ElectronicParts"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
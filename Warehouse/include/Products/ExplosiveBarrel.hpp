@@ -14,13 +14,16 @@ namespace warehouse
 class ExplosiveBarrel : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::ExplosiveBarrel;  ///< Type id of the class
+
     ExplosiveBarrel(const std::string &name, float size) :
             BaseProduct(
                     name,
                     size,
-                    warehouseInterface::ProductLabelFlags::explosives | warehouseInterface::ProductLabelFlags::handleWithCare)
+                    warehouseInterface::ProductLabelFlags::explosives | warehouseInterface::ProductLabelFlags::handleWithCare,
+                    productType)
     {}
 
-    std::string getClassName() const override { return "ExplosiveBarrel"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
@@ -14,12 +14,15 @@ namespace warehouse
 class GlassWare : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::GlassWare;  ///< Type id of the class
+
     GlassWare(const std::string &name, float size) :
             BaseProduct(name,
                         size,
-                        warehouseInterface::ProductLabelFlags::fragile | warehouseInterface::ProductLabelFlags::upWard)
+                        warehouseInterface::ProductLabelFlags::fragile | warehouseInterface::ProductLabelFlags::upWard,
+                        productType)
     {}
 
-    std::string getClassName() const override { return "GlassWare"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
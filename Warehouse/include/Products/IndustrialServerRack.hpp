@@ -14,10 +14,12 @@ namespace warehouse
 class IndustrialServerRack : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::IndustrialServerRack;  ///< Type id of the class
+
     IndustrialServerRack(const std::string &name, float size) :
-            BaseProduct(name, size, warehouseInterface::ProductLabelFlags::esdSensitive)
+            BaseProduct(name, size, warehouseInterface::ProductLabelFlags::esdSensitive, productType)
     {}
 
-    std::string getClassName() const override { return "IndustrialServerRack"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
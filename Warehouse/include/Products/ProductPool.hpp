@@ -0,0 +1,274 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Slab allocator for product objects
+ *
+ * Blocks are grouped in size classes of 16 bytes up to maxBlockSize, larger requests go to the
+ * global operator new. Every thread keeps free lists of its own and trades blocks with the shared
+ * lists in batches, so allocating and freeing a product takes no lock in the steady state. Slabs
+ * are never returned to the system: freed blocks are reused by the next products of their size.
+ *
+ * The global pool is opt-in: it hands every request to the global operator new unless it is
+ * enabled before the first allocation, which fixes the choice for the rest of the process.
+ */
+class ProductPool
+{
+public:
+    static constexpr std::size_t granularity = 16;   ///< Block sizes are multiples of this, which keeps max_align_t alignment
+    static constexpr std::size_t maxBlockSize = 128;  ///< Largest pooled block
+    static constexpr std::size_t batchSize = 64;      ///< Blocks moved between a thread and the shared lists at once
+
+    ProductPool() : ProductPool(Mode::pooled) {}
+
+    ProductPool(const ProductPool &) = delete;
+    ProductPool &operator=(const ProductPool &) = delete;
+
+    /**
+     * @brief Get the pool shared by the whole process
+     *
+     * The pool is never destroyed, products owned by static objects may outlive every other static.
+     */
+    static ProductPool &global()
+    {
+        static auto *pool = new ProductPool(Mode::open);
+        return *pool;
+    }
+
+    /**
+     * @brief Choose whether the pool serves allocations, possible only until the first allocation
+     * @param pooled Serve allocations from slabs instead of the global operator new
+     * @return true if the pool now works as requested
+     */
+    bool configure(bool pooled)
+    {
+        auto expected = Mode::open;
+        const auto requested = pooled ? Mode::pooled : Mode::unpooled;
+        return mode_.compare_exchange_strong(expected, requested) || expected == requested;
+    }
+
+    /**
+     * @brief Check whether allocations are served from slabs
+     */
+    bool pooled() const { return mode_.load(std::memory_order_acquire) == Mode::pooled; }
+
+    /**
+     * @brief Allocate memory for an object
+     * @param size Object size in bytes
+     */
+    void *allocate(std::size_t size)
+    {
+        if (size > maxBlockSize || !latchMode())
+            return ::operator new(size);
+
+        auto *cache = localCache();
+        if (!cache)
+        {
+            FreeList list{};
+            refill(sizeClass(size), list, 1);
+            return list.pop();
+        }
+        auto &list = cache->lists[sizeClass(size)];
+        if (!list.head)
+            refill(sizeClass(size), list, batchSize);
+        return list.pop();
+    }
+
+    /**
+     * @brief Free memory returned by allocate()
+     * @param memory Allocated memory
+     * @param size Size passed to allocate()
+     */
+    void deallocate(void *memory, std::size_t size) noexcept
+    {
+        if (size > maxBlockSize || !pooled())
+        {
+            ::operator delete(memory);
+            return;
+        }
+
+        auto *cache = localCache();
+        if (!cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shared_[sizeClass(size)].push(memory);
+            return;
+        }
+        auto &list = cache->lists[sizeClass(size)];
+        list.push(memory);
+        if (list.count > 4 * batchSize)
+            spill(sizeClass(size), list, list.count - 2 * batchSize);
+    }
+
+    /**
+     * @brief Make sure the calling thread can allocate objects without touching the shared lists
+     * @param count Number of objects about to be allocated
+     * @param size Object size in bytes
+     */
+    void reserve(std::size_t count, std::size_t size)
+    {
+        if (size > maxBlockSize || !latchMode())
+            return;
+        auto *cache = localCache();
+        if (!cache)
+            return;
+        auto &list = cache->lists[sizeClass(size)];
+        if (list.count < count)
+            refill(sizeClass(size), list, count - list.count);
+    }
+
+    /**
+     * @brief Size of the block holding an object, objects with equal block sizes share free lists
+     */
+    static std::size_t blockSizeOf(std::size_t size) { return size > maxBlockSize ? size : blockSize(sizeClass(size)); }
+
+private:
+    static constexpr std::size_t classCount = maxBlockSize / granularity;
+
+    enum class Mode : std::uint8_t
+    {
+        open,      ///< Not configured and nothing allocated yet
+        pooled,    ///< Allocations are served from slabs
+        unpooled,  ///< Allocations go to the global operator new
+    };
+
+    explicit ProductPool(Mode mode) : mode_(mode), mutex_(), shared_(), slabs_() {}
+
+    /**
+     * @brief Fix the mode on the first allocation, an unconfigured pool stays out of the way
+     * @return true if allocations are served from slabs
+     */
+    bool latchMode()
+    {
+        auto mode = mode_.load(std::memory_order_acquire);
+        if (mode == Mode::open && mode_.compare_exchange_strong(mode, Mode::unpooled))
+            return false;
+        return mode == Mode::pooled;
+    }
+
+    struct Block
+    {
+        Block *next;
+    };
+
+    /**
+     * @brief Singly linked list threaded through free blocks
+     */
+    struct FreeList
+    {
+        Block *head = nullptr;
+        std::size_t count = 0;
+
+        void push(void *memory)
+        {
+            auto *block = static_cast<Block *>(memory);
+            block->next = head;
+            head = block;
+            ++count;
+        }
+
+        void *pop()
+        {
+            auto *block = head;
+            head = block->next;
+            --count;
+            return block;
+        }
+    };
+
+    /**
+     * @brief Free lists of one thread, handed back to the shared lists when the thread exits
+     */
+    struct Cache
+    {
+        explicit Cache(ProductPool &pool) : owner(pool), lists() {}
+
+        Cache(const Cache &) = delete;
+        Cache &operator=(const Cache &) = delete;
+
+        ~Cache()
+        {
+            destroyed() = true;
+            for (std::size_t i = 0; i < classCount; ++i)
+                owner.spill(i, lists[i], lists[i].count);
+        }
+
+        ProductPool &owner;
+        std::array<FreeList, classCount> lists;
+    };
+
+    static std::size_t sizeClass(std::size_t size) { return size ? (size - 1) / granularity : 0; }
+    static std::size_t blockSize(std::size_t sizeClass) { return (sizeClass + 1) * granularity; }
+
+    /// Set once the cache of the calling thread is gone, it stays readable while thread_local objects are destroyed
+    static bool &destroyed()
+    {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    /**
+     * @brief Get the free lists of the calling thread, nullptr if the thread is exiting
+     */
+    Cache *localCache()
+    {
+        if (this != &global() || destroyed())
+            return nullptr;
+        thread_local Cache cache(global());
+        return &cache;
+    }
+
+    /**
+     * @brief Move blocks from the shared lists to a thread list, carving a new slab for the missing ones
+     */
+    void refill(std::size_t sizeClass, FreeList &list, std::size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &shared = shared_[sizeClass];
+        while (count && shared.head)
+        {
+            list.push(shared.pop());
+            --count;
+        }
+        if (!count)
+            return;
+
+        const auto size = blockSize(sizeClass);
+        const auto blocks = count < batchSize ? batchSize : count;
+        slabs_.emplace_back(new char[blocks * size]);
+        auto *slab = slabs_.back().get();
+        for (std::size_t i = blocks; i > count; --i)
+            shared.push(slab + (i - 1) * size);
+        for (std::size_t i = count; i > 0; --i)
+            list.push(slab + (i - 1) * size);
+    }
+
+    /**
+     * @brief Move blocks from a thread list to the shared lists
+     */
+    void spill(std::size_t sizeClass, FreeList &list, std::size_t count) noexcept
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &shared = shared_[sizeClass];
+        for (; count && list.head; --count)
+            shared.push(list.pop());
+    }
+
+    std::atomic<Mode> mode_;                      ///< Whether allocations are served from slabs
+    std::mutex mutex_;                            ///< Guards shared_ and slabs_
+    std::array<FreeList, classCount> shared_;     ///< Free blocks of no particular thread, per size class
+    std::vector<std::unique_ptr<char[]>> slabs_;  ///< Memory of every block
+};
+
+}  // namespace warehouse
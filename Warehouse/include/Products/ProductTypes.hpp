@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Products/StringInterner.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief The product classes known to ProductFactory, X(className) is expanded once per class
+ *
+ * The position in the list is the type id of the class, so new classes are appended.
+ */
+#define WAREHOUSE_PRODUCT_TYPES(X) \
+    X(IndustrialServerRack)        \
+    X(GlassWare)                   \
+    X(ExplosiveBarrel)             \
+    X(ElectronicParts)             \
+    X(AstronautsIceCream)          \
+    X(AcetoneBarrel)               \
+    X(TV)
+
+namespace warehouse
+{
+
+/**
+ * @brief Compile-time id of a product class
+ */
+enum class ProductTypeId : std::uint8_t
+{
+    unknown = 0,  ///< Products outside WAREHOUSE_PRODUCT_TYPES
+#define WAREHOUSE_PRODUCT_TYPE_ID(className) className,
+    WAREHOUSE_PRODUCT_TYPES(WAREHOUSE_PRODUCT_TYPE_ID)
+#undef WAREHOUSE_PRODUCT_TYPE_ID
+};
+
+/// Class names indexed by type id, empty for ProductTypeId::unknown
+constexpr std::array productTypeNames{
+        std::string_view(),
+#define WAREHOUSE_PRODUCT_TYPE_NAME(className) std::string_view(#className),
+        WAREHOUSE_PRODUCT_TYPES(WAREHOUSE_PRODUCT_TYPE_NAME)
+#undef WAREHOUSE_PRODUCT_TYPE_NAME
+};
+
+constexpr std::string_view productTypeName(ProductTypeId type)
+{
+    return productTypeNames[static_cast<std::size_t>(type)];
+}
+
+/**
+ * @brief Seeded 32-bit FNV-1a hash of a class name
+ */
+constexpr std::uint32_t productTypeHash(std::string_view className, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (const char c : className)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+/// Slots of the class name hash table, a power of two
+constexpr std::size_t productTypeSlots = 16;
+
+static_assert(productTypeNames.size() - 1 <= productTypeSlots, "Too many product types for the hash table");
+
+/**
+ * @brief Find the first seed that maps every class name to a slot of its own
+ * @return The seed, 0xFFFFFFFF if there is none below the search limit
+ */
+constexpr std::uint32_t findProductTypeSeed()
+{
+    for (std::uint32_t seed = 0; seed < 4096; ++seed)
+    {
+        std::array<bool, productTypeSlots> taken{};
+        bool collides = false;
+        for (std::size_t i = 1; i < productTypeNames.size() && !collides; ++i)
+        {
+            const auto slot = productTypeHash(productTypeNames[i], seed) & (productTypeSlots - 1);
+            collides = taken[slot];
+            taken[slot] = true;
+        }
+        if (!collides)
+            return seed;
+    }
+    return 0xFFFFFFFF;
+}
+
+/// Seed of the perfect hash of the class names
+constexpr std::uint32_t productTypeSeed = findProductTypeSeed();
+
+static_assert(productTypeSeed != 0xFFFFFFFF, "No perfect hash seed for the product types, grow productTypeSlots");
+
+/// Type id per hash slot, ProductTypeId::unknown for empty slots
+constexpr std::array<ProductTypeId, productTypeSlots> productTypeTable = []() {
+    std::array<ProductTypeId, productTypeSlots> table{};
+    for (std::size_t i = 1; i < productTypeNames.size(); ++i)
+        table[productTypeHash(productTypeNames[i], productTypeSeed) & (productTypeSlots - 1)] = static_cast<ProductTypeId>(i);
+    return table;
+}();
+
+/**
+ * @brief Find the type id of a class name with one hash and one string compare
+ * @param className Product class name
+ * @return Type id of the class, ProductTypeId::unknown if the class is not in WAREHOUSE_PRODUCT_TYPES
+ */
+constexpr ProductTypeId productTypeId(std::string_view className)
+{
+    const auto type = productTypeTable[productTypeHash(className, productTypeSeed) & (productTypeSlots - 1)];
+    return productTypeName(type) == className ? type : ProductTypeId::unknown;
+}
+
+/**
+ * @brief Get the class name of a type id interned in StringInterner::global()
+ * @return Class symbol, noSymbol for ProductTypeId::unknown
+ */
+inline Symbol productTypeSymbol(ProductTypeId type)
+{
+    static const auto symbols = []() {
+        std::array<Symbol, productTypeNames.size()> table{};
+        for (std::size_t i = 1; i < productTypeNames.size(); ++i)
+            table[i] = StringInterner::global().intern(productTypeNames[i]);
+        return table;
+    }();
+    return symbols[static_cast<std::size_t>(type)];
+}
+
+}  // namespace warehouse
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace warehouse
+{
+
+/// Interned string id, equal strings have equal symbols
+using Symbol = std::uint32_t;
+
+/// Symbol of no string, never returned by StringInterner::intern()
+constexpr Symbol noSymbol = 0;
+
+/**
+ * @brief Thread-safe table of unique strings with stable 32-bit ids
+ *
+ * Strings are never removed, so symbols and the views returned by view() stay valid for the
+ * lifetime of the interner. intern() and find() take a shared lock for strings that are already
+ * known and an exclusive lock only to add new ones, view() does not lock at all: the symbol table
+ * is split into segments of doubling size that never move once published.
+ */
+class StringInterner
+{
+public:
+    StringInterner() : mutex_(), lookup_(), blocks_(), block_(nullptr), blockUsed_(0), count_(1), segments_() {}
+
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    ~StringInterner()
+    {
+        for (auto &segment : segments_)
+            delete[] segment.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the interner shared by the whole process
+     */
+    static StringInterner &global()
+    {
+        static StringInterner interner;
+        return interner;
+    }
+
+    /**
+     * @brief Get the symbol of a string, adding the string if it is new
+     * @param text String to intern
+     * @return Symbol of the string, never noSymbol
+     */
+    Symbol intern(std::string_view text)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            const auto found = lookup_.find(text);
+            if (found != lookup_.end())
+                return found->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        const auto found = lookup_.find(text);
+        if (found != lookup_.end())
+            return found->second;
+
+        const auto stored = store(text);
+        const auto symbol = static_cast<Symbol>(count_);
+        const auto [segment, offset] = locate(symbol);
+        auto *entries = segments_[segment].load(std::memory_order_relaxed);
+        if (!entries)
+        {
+            entries = new std::string_view[segmentSize(segment)];
+            segments_[segment].store(entries, std::memory_order_release);
+        }
+        entries[offset] = stored;
+        lookup_.emplace(stored, symbol);
+        ++count_;
+        return symbol;
+    }
+
+    /**
+     * @brief Get the symbol of a string without adding it
+     * @param text String to look up
+     * @return Symbol of the string, noSymbol if it was never interned
+     */
+    Symbol find(std::string_view text) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const auto found = lookup_.find(text);
+        return found == lookup_.end() ? noSymbol : found->second;
+    }
+
+    /**
+     * @brief Get the string of a symbol
+     * @param symbol Symbol returned by this interner, or noSymbol
+     * @return The interned string, empty for noSymbol
+     */
+    std::string_view view(Symbol symbol) const
+    {
+        if (symbol == noSymbol)
+            return std::string_view();
+        const auto [segment, offset] = locate(symbol);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    /**
+     * @brief Number of interned strings
+     */
+    std::size_t size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return count_ - 1;
+    }
+
+private:
+    static constexpr std::size_t blockSize = 64 * 1024;  ///< Bytes per character block
+    static constexpr unsigned firstSegmentBits = 10;     ///< Segment k holds 2^(k + firstSegmentBits) symbols
+    static constexpr std::size_t segmentCount = 32 - firstSegmentBits + 1;
+
+    static std::size_t segmentSize(std::size_t segment) { return std::size_t{1} << (segment + firstSegmentBits); }
+
+    /**
+     * @brief Find the segment and the offset in the segment of a symbol
+     */
+    static std::pair<std::size_t, std::size_t> locate(Symbol symbol)
+    {
+        const auto biased = static_cast<std::uint64_t>(symbol) + (std::uint64_t{1} << firstSegmentBits);
+        const auto bit = static_cast<unsigned>(63 - __builtin_clzll(biased));
+        return {bit - firstSegmentBits, biased - (std::uint64_t{1} << bit)};
+    }
+
+    /**
+     * @brief Copy a string into the character blocks, long strings get a block of their own
+     */
+    std::string_view store(std::string_view text)
+    {
+        if (text.empty())
+            return std::string_view();
+
+        char *destination = nullptr;
+        if (text.size() > blockSize / 4)
+        {
+            blocks_.emplace_back(new char[text.size()]);
+            destination = blocks_.back().get();
+        }
+        else
+        {
+            if (!block_ || blockUsed_ + text.size() > blockSize)
+            {
+                blocks_.emplace_back(new char[blockSize]);
+                block_ = blocks_.back().get();
+                blockUsed_ = 0;
+            }
+            destination = block_ + blockUsed_;
+            blockUsed_ += text.size();
+        }
+        std::memcpy(destination, text.data(), text.size());
+        return std::string_view(destination, text.size());
+    }
+
+    mutable std::shared_mutex mutex_;                                          ///< Guards lookup_, blocks_ and adding symbols
+    std::unordered_map<std::string_view, Symbol> lookup_;                      ///< Symbol per interned string
+    std::vector<std::unique_ptr<char[]>> blocks_;                              ///< Storage of the interned characters
+    char *block_;                                                              ///< Block receiving short strings
+    std::size_t blockUsed_;                                                    ///< Bytes used in block_
+    std::size_t count_;                                                        ///< Next symbol
+    std::array<std::atomic<std::string_view *>, segmentCount> segments_;       ///< Symbol table segments
+};
+
+}  // namespace warehouse
@@ -14,6 +14,8 @@ namespace warehouse
 class TV : public BaseProduct
 {
 public:
+    static constexpr ProductTypeId productType = ProductTypeId::TV;  ///< Type id of the class
+
     /**
      * @brief Construct a new TV product
      * @param name Name of the TV
@@ -22,9 +24,10 @@ public:
     TV(const std::string &name, float size) :
             BaseProduct(name,
                         size,
-                        warehouseInterface::ProductLabelFlags::fragile | warehouseInterface::ProductLabelFlags::keepDry)
+                        warehouseInterface::ProductLabelFlags::fragile | warehouseInterface::ProductLabelFlags::keepDry,
+                        productType)
     {}
 
-    std::string getClassName() const override { return "TV"; }
+    std::string getClassName() const override { return std::string(productTypeName(productType)); }
 };
 }  // namespace warehouse
\ No newline at end of file
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <Departments/Occupancy.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Compact binary counterpart of WarehouseStateJson
+ *
+ * Layout (native little-endian byte order, every section starts at a multiple of 8 bytes):
+ * - Header
+ * - DepartmentRecord[departmentCount]
+ * - uint32 string offsets[stringCount + 1], followed by the concatenated string bytes
+ * - uint32 product class string ids[classCount]
+ * - float item sizes[itemCount]
+ * - uint32 item name string ids[itemCount]
+ * - uint16 item product class ids[itemCount], indices into the product class table
+ * - uint8 item flags[itemCount]
+ *
+ * Items of a department are stored contiguously in storage order. The checksum covers
+ * everything after the header.
+ */
+namespace snapshot
+{
+constexpr char magic[8] = {'W', 'H', 'S', 'N', 'A', 'P', '\0', '\0'};  ///< File signature
+constexpr std::uint32_t version = 2;                                  ///< Current format version
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t departmentCount;
+    std::uint32_t stringCount;
+    std::uint32_t classCount;
+    std::uint64_t itemCount;
+    std::uint64_t stringBytes;
+    std::uint64_t checksum;
+};
+
+struct DepartmentRecord
+{
+    std::uint32_t classId;    ///< String id of the department class name
+    float maxOccupancy;       ///< Maximum allowed occupancy
+    float occupancy;          ///< Item sizes summed in occupancy units, as a load would compute it
+    std::uint32_t reserved;   ///< Zero
+    std::uint64_t firstItem;  ///< Index of the first item in the item columns
+    std::uint64_t itemCount;  ///< Number of stored items
+};
+
+static_assert(sizeof(Header) == 48, "snapshot header must not contain padding");
+static_assert(sizeof(DepartmentRecord) == 32, "snapshot department record must not contain padding");
+
+/**
+ * @brief Round a section size up to the section alignment
+ */
+constexpr std::size_t aligned(std::size_t size)
+{
+    return (size + 7) & ~static_cast<std::size_t>(7);
+}
+
+/**
+ * @brief FNV-1a over 64-bit words, the tail is zero padded
+ * @param data First byte
+ * @param size Number of bytes
+ * @return 64-bit checksum
+ */
+inline std::uint64_t checksum(const char *data, std::size_t size)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    if (i < size)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + i, size - i);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+}  // namespace snapshot
+
+/**
+ * @brief Builds a binary snapshot department by department
+ *
+ * The string table holds at most 4 GiB of string bytes and the product class table at most
+ * 65536 classes.
+ */
+class SnapshotWriter
+{
+public:
+    SnapshotWriter() :
+            stringOffsets_{0},
+            stringBytes_(),
+            stringSlots_(16, 0),
+            classes_(),
+            classIds_(),
+            departments_(),
+            occupancy_(0),
+            sizes_(),
+            names_(),
+            itemClasses_(),
+            flags_()
+    {}
+
+    /**
+     * @brief Start a department, the following items belong to it
+     * @param className Department class name
+     * @param maxOccupancy Maximum allowed occupancy
+     */
+    void beginDepartment(std::string_view className, float maxOccupancy)
+    {
+        departments_.push_back({intern(className), maxOccupancy, 0.0f, 0, sizes_.size(), 0});
+        occupancy_ = 0;
+    }
+
+    /**
+     * @brief Append an item to the current department
+     * @param classId Product class id returned by productClass()
+     * @param name Product name
+     * @param size Product size
+     * @param flags Product flags
+     */
+    void addItem(std::uint16_t classId, std::string_view name, float size, std::uint8_t flags)
+    {
+        sizes_.push_back(size);
+        names_.push_back(intern(name));
+        itemClasses_.push_back(classId);
+        flags_.push_back(flags);
+        occupancy_ += toOccupancyUnits(size);
+        departments_.back().occupancy = fromOccupancyUnits(occupancy_);
+        ++departments_.back().itemCount;
+    }
+
+    /**
+     * @brief Get the id of a product class, callers cache it for runs of equally typed products
+     * @param className Product class name
+     * @return Index into the product class table
+     */
+    std::uint16_t productClass(std::string_view className)
+    {
+        const auto id = intern(className);
+        const auto found = classIds_.find(id);
+        if (found != classIds_.end())
+            return found->second;
+
+        const auto classId = static_cast<std::uint16_t>(classes_.size());
+        classes_.push_back(id);
+        classIds_.emplace(id, classId);
+        return classId;
+    }
+
+    /**
+     * @brief Serialize everything added so far
+     * @return Snapshot bytes
+     */
+    std::string finish() const
+    {
+        const std::size_t stringCount = stringOffsets_.size() - 1;
+        const std::size_t itemCount = sizes_.size();
+        const std::size_t total = sizeof(snapshot::Header) + departments_.size() * sizeof(snapshot::DepartmentRecord) +
+                                  snapshot::aligned(stringOffsets_.size() * sizeof(std::uint32_t) + stringBytes_.size()) +
+                                  snapshot::aligned(classes_.size() * sizeof(std::uint32_t)) +
+                                  snapshot::aligned(itemCount * sizeof(float)) +
+                                  snapshot::aligned(itemCount * sizeof(std::uint32_t)) +
+                                  snapshot::aligned(itemCount * sizeof(std::uint16_t)) + snapshot::aligned(itemCount);
+
+        std::string out(total, '\0');
+        std::size_t offset = sizeof(snapshot::Header);
+        const auto put = [&out, &offset](const void *data, std::size_t size) {
+            if (size)
+                std::memcpy(&out[offset], data, size);
+            offset += size;
+        };
+        const auto align = [&offset]() { offset = snapshot::aligned(offset); };
+
+        put(departments_.data(), departments_.size() * sizeof(snapshot::DepartmentRecord));
+
+        put(stringOffsets_.data(), stringOffsets_.size() * sizeof(std::uint32_t));
+        put(stringBytes_.data(), stringBytes_.size());
+        align();
+
+        put(classes_.data(), classes_.size() * sizeof(std::uint32_t));
+        align();
+        put(sizes_.data(), itemCount * sizeof(float));
+        align();
+        put(names_.data(), itemCount * sizeof(std::uint32_t));
+        align();
+        put(itemClasses_.data(), itemCount * sizeof(std::uint16_t));
+        align();
+        put(flags_.data(), itemCount);
+        align();
+
+        snapshot::Header header{};
+        std::memcpy(header.magic, snapshot::magic, sizeof(header.magic));
+        header.version = snapshot::version;
+        header.departmentCount = static_cast<std::uint32_t>(departments_.size());
+        header.stringCount = static_cast<std::uint32_t>(stringCount);
+        header.classCount = static_cast<std::uint32_t>(classes_.size());
+        header.itemCount = itemCount;
+        header.stringBytes = stringBytes_.size();
+        header.checksum = snapshot::checksum(out.data() + sizeof(header), out.size() - sizeof(header));
+        std::memcpy(&out[0], &header, sizeof(header));
+        return out;
+    }
+
+private:
+    /**
+     * @brief Get the id of a string, adding it to the string table if needed
+     *
+     * The lookup table is an open addressing hash set of string ids, so every string is stored
+     * once, directly in its serialized form.
+     */
+    std::uint32_t intern(std::string_view str)
+    {
+        const std::size_t mask = stringSlots_.size() - 1;
+        std::size_t slot = std::hash<std::string_view>{}(str) & mask;
+        while (stringSlots_[slot])
+        {
+            const auto id = stringSlots_[slot] - 1;
+            if (string(id) == str)
+                return id;
+            slot = (slot + 1) & mask;
+        }
+
+        const auto id = static_cast<std::uint32_t>(stringOffsets_.size() - 1);
+        stringBytes_.append(str);
+        stringOffsets_.push_back(static_cast<std::uint32_t>(stringBytes_.size()));
+        stringSlots_[slot] = id + 1;
+        if (stringOffsets_.size() * 2 > stringSlots_.size())
+            growStringSlots();
+        return id;
+    }
+
+    std::string_view string(std::uint32_t id) const
+    {
+        return std::string_view(stringBytes_).substr(stringOffsets_[id], stringOffsets_[id + 1] - stringOffsets_[id]);
+    }
+
+    void growStringSlots()
+    {
+        std::vector<std::uint32_t> slots(stringSlots_.size() * 2, 0);
+        const std::size_t mask = slots.size() - 1;
+        for (std::uint32_t id = 0; id + 1 < stringOffsets_.size(); ++id)
+        {
+            std::size_t slot = std::hash<std::string_view>{}(string(id)) & mask;
+            while (slots[slot])
+                slot = (slot + 1) & mask;
+            slots[slot] = id + 1;
+        }
+        stringSlots_.swap(slots);
+    }
+
+    std::vector<std::uint32_t> stringOffsets_;                   ///< String table offsets, one past the last string at the end
+    std::string stringBytes_;                                    ///< String table bytes
+    std::vector<std::uint32_t> stringSlots_;                     ///< String table lookup, id + 1 per used slot
+    std::vector<std::uint32_t> classes_;                         ///< Product class table, string ids
+    std::unordered_map<std::uint32_t, std::uint16_t> classIds_;  ///< Product class table lookup
+    std::vector<snapshot::DepartmentRecord> departments_;        ///< Department records
+    OccupancyUnits occupancy_;                                   ///< Exact occupancy of the current department
+    std::vector<float> sizes_;                                   ///< Item size column
+    std::vector<std::uint32_t> names_;                           ///< Item name column
+    std::vector<std::uint16_t> itemClasses_;                     ///< Item product class column
+    std::vector<std::uint8_t> flags_;                            ///< Item flags column
+};
+
+/**
+ * @brief Validating read-only view of a binary snapshot
+ *
+ * The view does not copy the snapshot, the underlying bytes must outlive it.
+ */
+class SnapshotReader
+{
+public:
+    /**
+     * @brief Amount of checking done when a snapshot is opened
+     */
+    enum class Validation
+    {
+        full,  ///< Verify the checksum and every id, O(snapshot size)
+        lazy   ///< Check the header, departments and class table only, O(departments + classes)
+    };
+
+    SnapshotReader() :
+            data_(nullptr),
+            header_(),
+            departments_(0),
+            stringOffsets_(0),
+            stringBytes_(0),
+            classes_(0),
+            sizes_(0),
+            names_(0),
+            itemClasses_(0),
+            flags_(0)
+    {}
+
+    /**
+     * @brief Attach the view to snapshot bytes
+     * @param data First byte of the snapshot
+     * @param size Snapshot length in bytes
+     * @param validation Checks to run, accessors stay inside the snapshot bytes either way
+     * @return true if the snapshot passed the checks, false otherwise
+     */
+    bool open(const char *data, std::size_t size, Validation validation = Validation::full)
+    {
+        data_ = nullptr;
+        if (!data || size < sizeof(snapshot::Header))
+            return false;
+
+        std::memcpy(&header_, data, sizeof(header_));
+        if (std::memcmp(header_.magic, snapshot::magic, sizeof(header_.magic)) != 0 || header_.version != snapshot::version)
+            return false;
+
+        // Section sizes are checked one at a time so that corrupted counts cannot overflow
+        const std::uint64_t itemCount = header_.itemCount;
+        if (itemCount > size || header_.stringBytes > size || header_.stringCount > size || header_.classCount > size ||
+            header_.departmentCount > size)
+            return false;
+
+        std::size_t offset = sizeof(snapshot::Header);
+        departments_ = offset;
+        offset += header_.departmentCount * sizeof(snapshot::DepartmentRecord);
+        stringOffsets_ = offset;
+        offset += (header_.stringCount + std::size_t{1}) * sizeof(std::uint32_t);
+        stringBytes_ = offset;
+        offset = snapshot::aligned(offset + header_.stringBytes);
+        classes_ = offset;
+        offset = snapshot::aligned(offset + header_.classCount * sizeof(std::uint32_t));
+        sizes_ = offset;
+        offset = snapshot::aligned(offset + itemCount * sizeof(float));
+        names_ = offset;
+        offset = snapshot::aligned(offset + itemCount * sizeof(std::uint32_t));
+        itemClasses_ = offset;
+        offset = snapshot::aligned(offset + itemCount * sizeof(std::uint16_t));
+        flags_ = offset;
+        offset = snapshot::aligned(offset + itemCount);
+        if (offset != size)
+            return false;
+
+        if (validation == Validation::full &&
+            snapshot::checksum(data + sizeof(snapshot::Header), size - sizeof(snapshot::Header)) != header_.checksum)
+            return false;
+
+        data_ = data;
+        if (!validateDepartments() || (validation == Validation::full && !validateItems()))
+        {
+            data_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    std::size_t departmentCount() const { return header_.departmentCount; }
+    std::size_t itemCount() const { return header_.itemCount; }
+    std::size_t classCount() const { return header_.classCount; }
+
+    snapshot::DepartmentRecord department(std::size_t index) const
+    {
+        return load<snapshot::DepartmentRecord>(departments_ + index * sizeof(snapshot::DepartmentRecord));
+    }
+
+    /**
+     * @brief Get a string by its id
+     * @return The string, empty for ids or offsets a lazily validated snapshot got wrong
+     */
+    std::string_view string(std::uint32_t id) const
+    {
+        if (id >= header_.stringCount)
+            return std::string_view();
+        const auto begin = load<std::uint32_t>(stringOffsets_ + id * sizeof(std::uint32_t));
+        const auto end = load<std::uint32_t>(stringOffsets_ + (id + std::size_t{1}) * sizeof(std::uint32_t));
+        if (begin > end || end > header_.stringBytes)
+            return std::string_view();
+        return std::string_view(data_ + stringBytes_ + begin, end - begin);
+    }
+
+    /**
+     * @brief Get a product class name by its class table index
+     * @return The class name, empty for out of range indices
+     */
+    std::string_view productClass(std::uint16_t classId) const
+    {
+        if (classId >= header_.classCount)
+            return std::string_view();
+        return string(load<std::uint32_t>(classes_ + classId * sizeof(std::uint32_t)));
+    }
+
+    float itemSize(std::size_t item) const { return load<float>(sizes_ + item * sizeof(float)); }
+    std::uint32_t itemName(std::size_t item) const { return load<std::uint32_t>(names_ + item * sizeof(std::uint32_t)); }
+    std::uint16_t itemClass(std::size_t item) const { return load<std::uint16_t>(itemClasses_ + item * sizeof(std::uint16_t)); }
+    std::uint8_t itemFlags(std::size_t item) const { return load<std::uint8_t>(flags_ + item); }
+
+private:
+    template <typename T>
+    T load(std::size_t offset) const
+    {
+        T value;
+        std::memcpy(&value, data_ + offset, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Check the department records and the product class table
+     */
+    bool validateDepartments() const
+    {
+        for (std::size_t i = 0; i < header_.classCount; ++i)
+        {
+            if (load<std::uint32_t>(classes_ + i * sizeof(std::uint32_t)) >= header_.stringCount)
+                return false;
+        }
+
+        std::uint64_t nextItem = 0;
+        for (std::size_t i = 0; i < header_.departmentCount; ++i)
+        {
+            const auto record = department(i);
+            if (record.classId >= header_.stringCount || record.firstItem != nextItem ||
+                record.itemCount > header_.itemCount - nextItem)
+                return false;
+            nextItem += record.itemCount;
+        }
+        return nextItem == header_.itemCount;
+    }
+
+    /**
+     * @brief Check that all string offsets and item ids stay inside the snapshot
+     */
+    bool validateItems() const
+    {
+        std::uint32_t previous = 0;
+        for (std::size_t i = 0; i <= header_.stringCount; ++i)
+        {
+            const auto offset = load<std::uint32_t>(stringOffsets_ + i * sizeof(std::uint32_t));
+            if (offset < previous || offset > header_.stringBytes || (i == 0 && offset != 0))
+                return false;
+            previous = offset;
+        }
+        if (previous != header_.stringBytes)
+            return false;
+
+        for (std::size_t i = 0; i < header_.itemCount; ++i)
+        {
+            if (itemName(i) >= header_.stringCount || itemClass(i) >= header_.classCount)
+                return false;
+        }
+        return true;
+    }
+
+    const char *data_;          ///< First snapshot byte, nullptr until a snapshot is opened
+    snapshot::Header header_;   ///< Copy of the snapshot header
+    std::size_t departments_;   ///< Offset of the department records
+    std::size_t stringOffsets_; ///< Offset of the string offset table
+    std::size_t stringBytes_;   ///< Offset of the string bytes
+    std::size_t classes_;       ///< Offset of the product class table
+    std::size_t sizes_;         ///< Offset of the item size column
+    std::size_t names_;         ///< Offset of the item name column
+    std::size_t itemClasses_;   ///< Offset of the item product class column
+    std::size_t flags_;         ///< Offset of the item flags column
+};
+
+}  // namespace warehouse
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <PicoJson/picojson.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Streaming JSON writer producing the same bytes as picojson::value::serialize
+ *
+ * Values are written as they are produced, without building a picojson::value tree. The writer
+ * does not sort object keys: callers emit keys in the alphabetical order picojson would use.
+ * Output is collected in memory, or flushed to a std::ostream in fixed-size chunks.
+ */
+class JsonSink
+{
+public:
+    static constexpr std::size_t flushThreshold = 64 * 1024;  ///< Buffered bytes before writing to the stream
+
+    /**
+     * @brief Construct a sink collecting the output in memory, see release()
+     */
+    JsonSink() : out_(nullptr), buffer_(), firstInScope_(), afterKey_(false) {}
+
+    /**
+     * @brief Construct a sink streaming the output
+     * @param out Destination stream, must outlive the sink
+     */
+    explicit JsonSink(std::ostream &out) : out_(&out), buffer_(), firstInScope_(), afterKey_(false)
+    {
+        buffer_.reserve(flushThreshold);
+    }
+
+    JsonSink(const JsonSink &) = delete;
+    JsonSink &operator=(const JsonSink &) = delete;
+
+    ~JsonSink() { flush(); }
+
+    void beginObject()
+    {
+        separate();
+        buffer_.push_back('{');
+        firstInScope_.push_back(true);
+    }
+
+    void endObject()
+    {
+        firstInScope_.pop_back();
+        buffer_.push_back('}');
+        flushIfFull();
+    }
+
+    void beginArray()
+    {
+        separate();
+        buffer_.push_back('[');
+        firstInScope_.push_back(true);
+    }
+
+    void endArray()
+    {
+        firstInScope_.pop_back();
+        buffer_.push_back(']');
+        flushIfFull();
+    }
+
+    /**
+     * @brief Write an object key, the next written value belongs to it
+     * @param name Key name
+     */
+    void key(const std::string &name)
+    {
+        separate();
+        picojson::serialize_str(name, std::back_inserter(buffer_));
+        buffer_.push_back(':');
+        afterKey_ = true;
+    }
+
+    void value(std::string_view text)
+    {
+        separate();
+        buffer_.push_back('"');
+        std::for_each(text.begin(), text.end(), picojson::serialize_str_char<std::back_insert_iterator<std::string>>{std::back_inserter(buffer_)});
+        buffer_.push_back('"');
+    }
+
+    void value(const std::string &text) { value(std::string_view(text)); }
+    void value(const char *text) { value(std::string_view(text)); }
+
+    /**
+     * @brief Write a number formatted like picojson
+     * @param number Finite number
+     * @throw std::overflow_error if the number is NaN or infinite, as picojson::value does
+     */
+    void value(double number)
+    {
+        if (std::isnan(number) || std::isinf(number))
+            throw std::overflow_error("");
+
+        separate();
+        char buf[64];
+        double integral;
+        const bool isIntegral = std::fabs(number) < static_cast<double>(1ULL << 53) && std::modf(number, &integral) == 0;
+        const int length = isIntegral ? std::snprintf(buf, sizeof(buf), "%.f", number)
+                                      : std::snprintf(buf, sizeof(buf), "%.17g", number);
+        buffer_.append(buf, static_cast<std::size_t>(length));
+    }
+
+    /**
+     * @brief Write an already serialized JSON value verbatim
+     * @param json Serialized JSON value
+     */
+    void rawValue(const std::string &json)
+    {
+        separate();
+        buffer_.append(json);
+        flushIfFull();
+    }
+
+    /**
+     * @brief Write the elements of an already serialized JSON array verbatim, as rawValue() would one by one
+     * @param json Serialized JSON array, "[]" writes nothing
+     */
+    void rawElements(const std::string &json)
+    {
+        if (json.size() <= 2)
+            return;
+        separate();
+        buffer_.append(json, 1, json.size() - 2);
+        flushIfFull();
+    }
+
+    /**
+     * @brief Write the buffered output to the stream, no-op for in-memory sinks
+     */
+    void flush()
+    {
+        if (out_ && !buffer_.empty())
+        {
+            out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+
+    /**
+     * @brief Hand over the collected output of an in-memory sink
+     * @return Serialized JSON
+     */
+    std::string release() { return std::move(buffer_); }
+
+private:
+    void separate()
+    {
+        if (afterKey_)
+        {
+            afterKey_ = false;
+            return;
+        }
+        if (firstInScope_.empty())
+            return;
+        if (firstInScope_.back())
+            firstInScope_.back() = false;
+        else
+            buffer_.push_back(',');
+    }
+
+    void flushIfFull()
+    {
+        if (buffer_.size() >= flushThreshold)
+            flush();
+    }
+
+    std::ostream *out_;               ///< Destination stream, nullptr for in-memory output
+    std::string buffer_;              ///< Pending output
+    std::vector<bool> firstInScope_;  ///< Per open object/array: no element written yet
+    bool afterKey_;                   ///< A key was written and waits for its value
+};
+
+}  // namespace warehouse
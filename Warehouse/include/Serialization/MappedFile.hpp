@@ -0,0 +1,90 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <string>
+
+namespace warehouse
+{
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * The mapping lives as long as the object. Pages are loaded by the kernel on first access, so
+ * opening a file costs the same regardless of its size.
+ */
+class MappedFile
+{
+public:
+    MappedFile() : data_(nullptr), size_(0) {}
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() { close(); }
+
+    /**
+     * @brief Map a file, replacing any previous mapping
+     * @param path File to map
+     * @return true if the file was opened and mapped, false otherwise
+     */
+    bool open(const std::string &path)
+    {
+        close();
+
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        struct stat info
+        {
+        };
+        if (::fstat(fd, &info) != 0 || info.st_size < 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        const auto size = static_cast<std::size_t>(info.st_size);
+        if (size == 0)
+        {
+            ::close(fd);
+            return true;
+        }
+
+        void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        data_ = static_cast<const char *>(data);
+        size_ = size;
+        return true;
+    }
+
+    /**
+     * @brief Unmap the file, no-op if nothing is mapped
+     */
+    void close()
+    {
+        if (data_)
+            ::munmap(const_cast<char *>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const char *begin() const { return data_; }
+    const char *end() const { return data_ + size_; }
+
+private:
+    const char *data_;  ///< First mapped byte, nullptr if nothing is mapped
+    std::size_t size_;  ///< Mapped length in bytes
+};
+
+}  // namespace warehouse
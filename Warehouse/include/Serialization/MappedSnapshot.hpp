@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Interfaces/IProduct.hpp>
+#include <Serialization/BinarySnapshot.hpp>
+#include <Serialization/MappedFile.hpp>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace warehouse
+{
+
+/**
+ * @brief Binary snapshot file mapped into memory, shared by the departments serving its items
+ *
+ * Items stay in the mapped pages until they are taken, only then the materializer turns them
+ * into heap products.
+ */
+class MappedSnapshot
+{
+public:
+    using Materializer = std::function<warehouseInterface::IProductPtr(const std::string &className, const std::string &name, float size)>;
+
+    /**
+     * @brief Construct a new mapped snapshot
+     * @param materialize Creates a product from its mapped description, nullptr for unknown classes
+     */
+    explicit MappedSnapshot(Materializer materialize) : file_(), reader_(), materialize_(std::move(materialize)) {}
+
+    MappedSnapshot(const MappedSnapshot &) = delete;
+    MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+    /**
+     * @brief Map a snapshot file
+     * @param path Snapshot written by Warehouse::saveWarehouseStateBinary()
+     * @param validation Checks to run, see SnapshotReader::Validation
+     * @return true if the file was mapped and passed the checks, false otherwise
+     */
+    bool open(const std::string &path, SnapshotReader::Validation validation)
+    {
+        return file_.open(path) && reader_.open(file_.data(), file_.size(), validation);
+    }
+
+    const SnapshotReader &reader() const { return reader_; }
+
+    warehouseInterface::IProductPtr materialize(const std::string &className, const std::string &name, float size) const
+    {
+        return materialize_(className, name, size);
+    }
+
+private:
+    MappedFile file_;             ///< Mapped snapshot bytes
+    SnapshotReader reader_;       ///< View over file_
+    Materializer materialize_;    ///< Turns taken items into products
+};
+
+}  // namespace warehouse
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <PicoJson/picojson.h>
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Streaming reader of WarehouseStateJson
+ *
+ * Built on the picojson parse context interface: departments and products are handed to the
+ * callbacks while the input is being tokenized, so no picojson::value tree is built and memory
+ * use does not depend on the number of stored items. Items are buffered only when a department
+ * object lists "items" before "class" and "maxOccupancy", which never happens for states written
+ * by picojson or JsonSink since they emit keys alphabetically.
+ */
+class WarehouseStateLoader
+{
+public:
+    using StateStart = std::function<void()>;
+    using DepartmentFactory = std::function<bool(const std::string &className, float maxOccupancy)>;
+    using ItemConsumer = std::function<bool(const std::string &className, const std::string &name, float size)>;
+
+    /**
+     * @brief Construct a new loader
+     * @param onStateStart Called once the "warehouseState" array is reached
+     * @param createDepartment Creates a department, returns false for unknown classes
+     * @param addItem Stores a product in the most recently created department, returns false to abort loading
+     */
+    WarehouseStateLoader(StateStart onStateStart, DepartmentFactory createDepartment, ItemConsumer addItem) :
+            onStateStart_(std::move(onStateStart)),
+            createDepartment_(std::move(createDepartment)),
+            addItem_(std::move(addItem))
+    {}
+
+    /**
+     * @brief Load a state from a character range, e.g. a string or a mapped file
+     * @return true if the state is valid (contains all required fields), false otherwise
+     */
+    template <typename Iter>
+    bool load(const Iter &first, const Iter &last)
+    {
+        RootContext ctx(*this);
+        picojson::input<Iter> in(first, last);
+        return picojson::_parse(ctx, in) && ctx.sawState_;
+    }
+
+    /**
+     * @brief Load a state from a stream
+     * @return true if the state is valid (contains all required fields), false otherwise
+     */
+    bool load(std::istream &in)
+    {
+        return load(std::istreambuf_iterator<char>(in.rdbuf()), std::istreambuf_iterator<char>());
+    }
+
+private:
+    /**
+     * @brief Parse context rejecting every JSON value, specialized contexts accept what they expect
+     */
+    struct RejectContext
+    {
+        bool set_null() { return false; }
+        bool set_bool(bool) { return false; }
+        bool set_number(double) { return false; }
+        template <typename Iter>
+        bool parse_string(picojson::input<Iter> &)
+        {
+            return false;
+        }
+        bool parse_array_start() { return false; }
+        template <typename Iter>
+        bool parse_array_item(picojson::input<Iter> &, std::size_t)
+        {
+            return false;
+        }
+        bool parse_array_stop(std::size_t) { return false; }
+        bool parse_object_start() { return false; }
+        template <typename Iter>
+        bool parse_object_item(picojson::input<Iter> &, const std::string &)
+        {
+            return false;
+        }
+        bool parse_object_stop() { return false; }
+    };
+
+    template <typename Iter>
+    static bool skipValue(picojson::input<Iter> &in)
+    {
+        picojson::null_parse_context ctx;
+        return picojson::_parse(ctx, in);
+    }
+
+    /**
+     * @brief Reads a string into a reused buffer
+     */
+    struct StringContext : RejectContext
+    {
+        explicit StringContext(std::string &out) : out_(out) {}
+
+        template <typename Iter>
+        bool parse_string(picojson::input<Iter> &in)
+        {
+            out_.clear();
+            return picojson::_parse_string(out_, in);
+        }
+
+        std::string &out_;
+    };
+
+    /**
+     * @brief Reads a number
+     */
+    struct NumberContext : RejectContext
+    {
+        explicit NumberContext(double &out) : out_(out) {}
+
+        bool set_number(double number)
+        {
+            out_ = number;
+            return true;
+        }
+
+        double &out_;
+    };
+
+    /**
+     * @brief Reads one product object, reused for every product of a department
+     */
+    struct ItemContext : RejectContext
+    {
+        void reset()
+        {
+            hasClass_ = hasName_ = hasSize_ = false;
+        }
+
+        bool parse_object_start() { return true; }
+        bool parse_object_stop() { return true; }
+
+        template <typename Iter>
+        bool parse_object_item(picojson::input<Iter> &in, const std::string &key)
+        {
+            if (key == "class")
+            {
+                StringContext ctx(className_);
+                return hasClass_ = picojson::_parse(ctx, in);
+            }
+            if (key == "name")
+            {
+                StringContext ctx(name_);
+                return hasName_ = picojson::_parse(ctx, in);
+            }
+            if (key == "size")
+            {
+                NumberContext ctx(size_);
+                return hasSize_ = picojson::_parse(ctx, in);
+            }
+            return skipValue(in);
+        }
+
+        bool complete() const { return hasClass_ && hasName_ && hasSize_; }
+
+        std::string className_{};
+        std::string name_{};
+        double size_{};
+        bool hasClass_{};
+        bool hasName_{};
+        bool hasSize_{};
+    };
+
+    struct PendingItem
+    {
+        std::string className;
+        std::string name;
+        float size;
+    };
+
+    /**
+     * @brief Reads one department object and streams its products
+     */
+    struct DepartmentContext : RejectContext
+    {
+        explicit DepartmentContext(WarehouseStateLoader &loader) : loader_(loader) {}
+
+        bool parse_object_start() { return true; }
+
+        template <typename Iter>
+        bool parse_object_item(picojson::input<Iter> &in, const std::string &key)
+        {
+            if (key == "class")
+            {
+                StringContext ctx(className_);
+                return hasClass_ = picojson::_parse(ctx, in);
+            }
+            if (key == "maxOccupancy")
+            {
+                NumberContext ctx(maxOccupancy_);
+                return hasMaxOccupancy_ = picojson::_parse(ctx, in);
+            }
+            if (key == "items")
+            {
+                if (!created_ && hasClass_ && hasMaxOccupancy_ && !create())
+                    return false;
+                ItemsContext ctx(*this);
+                return picojson::_parse(ctx, in);
+            }
+            return skipValue(in);
+        }
+
+        bool parse_object_stop()
+        {
+            if (!created_ && !(hasClass_ && hasMaxOccupancy_ && create()))
+                return false;
+
+            for (const auto &item : pending_)
+            {
+                if (!loader_.addItem_(item.className, item.name, item.size))
+                    return false;
+            }
+            pending_.clear();
+            return true;
+        }
+
+        /**
+         * @brief Reads the "items" array of the enclosing department
+         */
+        struct ItemsContext : RejectContext
+        {
+            explicit ItemsContext(DepartmentContext &department) : department_(department) {}
+
+            bool parse_array_start() { return true; }
+            bool parse_array_stop(std::size_t) { return true; }
+
+            template <typename Iter>
+            bool parse_array_item(picojson::input<Iter> &in, std::size_t)
+            {
+                auto &item = department_.item_;
+                item.reset();
+                if (!picojson::_parse(item, in) || !item.complete())
+                    return false;
+                return department_.consume(item.className_, item.name_, static_cast<float>(item.size_));
+            }
+
+            DepartmentContext &department_;
+        };
+
+        bool consume(const std::string &className, const std::string &name, float size)
+        {
+            if (!created_)
+            {
+                pending_.push_back({className, name, size});
+                return true;
+            }
+            return loader_.addItem_(className, name, size);
+        }
+
+        bool create()
+        {
+            created_ = loader_.createDepartment_(className_, static_cast<float>(maxOccupancy_));
+            return created_;
+        }
+
+        WarehouseStateLoader &loader_;
+        std::string className_{};
+        double maxOccupancy_{};
+        bool hasClass_{};
+        bool hasMaxOccupancy_{};
+        bool created_{};
+        ItemContext item_{};
+        std::vector<PendingItem> pending_{};
+    };
+
+    /**
+     * @brief Reads the "warehouseState" array
+     */
+    struct DepartmentsContext : RejectContext
+    {
+        explicit DepartmentsContext(WarehouseStateLoader &loader) : loader_(loader) {}
+
+        bool parse_array_start() { return true; }
+        bool parse_array_stop(std::size_t) { return true; }
+
+        template <typename Iter>
+        bool parse_array_item(picojson::input<Iter> &in, std::size_t)
+        {
+            DepartmentContext ctx(loader_);
+            return picojson::_parse(ctx, in);
+        }
+
+        WarehouseStateLoader &loader_;
+    };
+
+    /**
+     * @brief Reads the top level object
+     */
+    struct RootContext : RejectContext
+    {
+        explicit RootContext(WarehouseStateLoader &loader) : loader_(loader) {}
+
+        bool parse_object_start() { return true; }
+        bool parse_object_stop() { return true; }
+
+        template <typename Iter>
+        bool parse_object_item(picojson::input<Iter> &in, const std::string &key)
+        {
+            if (key != "warehouseState")
+                return skipValue(in);
+
+            loader_.onStateStart_();
+            sawState_ = true;
+            DepartmentsContext ctx(loader_);
+            return picojson::_parse(ctx, in);
+        }
+
+        WarehouseStateLoader &loader_;
+        bool sawState_{};
+    };
+
+    StateStart onStateStart_;             ///< Called when the departments array is reached
+    DepartmentFactory createDepartment_;  ///< Creates departments by class name
+    ItemConsumer addItem_;                ///< Stores products in the last created department
+};
+
+}  // namespace warehouse
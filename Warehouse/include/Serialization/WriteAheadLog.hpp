@@ -0,0 +1,319 @@
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <Serialization/BinarySnapshot.hpp>
+#include <Serialization/MappedFile.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace warehouse
+{
+
+/**
+ * @brief Operation log records and their on-disk framing
+ *
+ * Every record is framed as uint32 payload length, uint32 payload checksum, payload. The payload
+ * holds uint8 type, uint8 present fields (1 = class name, 2 = name, 4 = minimum size, 8 = maximum
+ * size), uint32 department, float size, then the present strings as uint32 length and bytes and the
+ * present sizes as floats. A log ends at the first frame that is truncated or fails its checksum,
+ * which is what a crash in the middle of a write leaves behind.
+ *
+ * Format 2 added the size range of take records. Format 1 logs decode unchanged, a frame with
+ * present fields this format does not know is rejected like a corrupted one.
+ */
+namespace wal
+{
+enum class RecordType : std::uint8_t
+{
+    department = 1,  ///< A department was added
+    addItem = 2,     ///< A product was stored in a department
+    takeItem = 3     ///< A product matching a query was taken from a department
+};
+
+struct Record
+{
+    RecordType type{};
+    std::uint32_t department{};              ///< Department index, unused for department records
+    std::optional<std::string> className{};  ///< Department class for department records, product class otherwise
+    std::optional<std::string> name{};       ///< Product name
+    float size{};                            ///< Product size, maximum occupancy for department records
+    std::optional<float> minSize{};          ///< Smallest requested item size of take records
+    std::optional<float> maxSize{};          ///< Largest requested item size of take records
+
+    static Record addDepartment(const std::string &className, float maxOccupancy)
+    {
+        return Record{RecordType::department, 0, className, std::nullopt, maxOccupancy, std::nullopt, std::nullopt};
+    }
+
+    static Record addItem(std::uint32_t department, const std::string &className, const std::string &name, float size)
+    {
+        return Record{RecordType::addItem, department, className, name, size, std::nullopt, std::nullopt};
+    }
+
+    static Record takeItem(std::uint32_t department, const std::optional<std::string> &className,
+                           const std::optional<std::string> &name, std::optional<float> minSize, std::optional<float> maxSize)
+    {
+        return Record{RecordType::takeItem, department, className, name, 0.0f, minSize, maxSize};
+    }
+};
+
+constexpr std::uint8_t knownFields = 1 | 2 | 4 | 8;  ///< Present fields of format 2
+
+constexpr std::size_t frameHeaderSize = 2 * sizeof(std::uint32_t);  ///< Length and checksum
+
+inline std::uint32_t frameChecksum(const char *data, std::size_t size)
+{
+    const auto hash = snapshot::checksum(data, size);
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+/**
+ * @brief Append a framed record
+ * @param out Destination buffer
+ * @param record Record to encode
+ */
+inline void encode(std::string &out, const Record &record)
+{
+    const auto frameStart = out.size();
+    out.append(frameHeaderSize, '\0');
+
+    const auto put = [&out](const void *data, std::size_t size) { out.append(static_cast<const char *>(data), size); };
+    const auto putString = [&put](const std::string &str) {
+        const auto length = static_cast<std::uint32_t>(str.size());
+        put(&length, sizeof(length));
+        put(str.data(), str.size());
+    };
+
+    const auto type = static_cast<std::uint8_t>(record.type);
+    const auto present = static_cast<std::uint8_t>((record.className ? 1 : 0) | (record.name ? 2 : 0) |
+                                                   (record.minSize ? 4 : 0) | (record.maxSize ? 8 : 0));
+    put(&type, sizeof(type));
+    put(&present, sizeof(present));
+    put(&record.department, sizeof(record.department));
+    put(&record.size, sizeof(record.size));
+    if (record.className)
+        putString(*record.className);
+    if (record.name)
+        putString(*record.name);
+    if (record.minSize)
+        put(&*record.minSize, sizeof(float));
+    if (record.maxSize)
+        put(&*record.maxSize, sizeof(float));
+
+    const auto length = static_cast<std::uint32_t>(out.size() - frameStart - frameHeaderSize);
+    const auto checksum = frameChecksum(out.data() + frameStart + frameHeaderSize, length);
+    std::memcpy(&out[frameStart], &length, sizeof(length));
+    std::memcpy(&out[frameStart + sizeof(length)], &checksum, sizeof(checksum));
+}
+
+/**
+ * @brief Decode the frame at the start of a buffer
+ * @param data First byte of the frame
+ * @param size Bytes available
+ * @param record Decoded record
+ * @return Size of the frame, 0 if the frame is truncated or corrupted
+ */
+inline std::size_t decode(const char *data, std::size_t size, Record &record)
+{
+    std::uint32_t length = 0;
+    std::uint32_t checksum = 0;
+    if (size < frameHeaderSize)
+        return 0;
+    std::memcpy(&length, data, sizeof(length));
+    std::memcpy(&checksum, data + sizeof(length), sizeof(checksum));
+    if (length > size - frameHeaderSize || frameChecksum(data + frameHeaderSize, length) != checksum)
+        return 0;
+
+    const char *in = data + frameHeaderSize;
+    const char *end = in + length;
+    const auto get = [&in, end](void *value, std::size_t valueSize) {
+        if (static_cast<std::size_t>(end - in) < valueSize)
+            return false;
+        std::memcpy(value, in, valueSize);
+        in += valueSize;
+        return true;
+    };
+    const auto getString = [&in, end, &get](std::optional<std::string> &str) {
+        std::uint32_t strLength = 0;
+        if (!get(&strLength, sizeof(strLength)) || static_cast<std::size_t>(end - in) < strLength)
+            return false;
+        str.emplace(in, strLength);
+        in += strLength;
+        return true;
+    };
+
+    std::uint8_t type = 0;
+    std::uint8_t present = 0;
+    record = Record{};
+    if (!get(&type, sizeof(type)) || !get(&present, sizeof(present)) || !get(&record.department, sizeof(record.department)) ||
+        !get(&record.size, sizeof(record.size)))
+        return 0;
+    if (type < static_cast<std::uint8_t>(RecordType::department) || type > static_cast<std::uint8_t>(RecordType::takeItem) ||
+        (present & ~knownFields))
+        return 0;
+    record.type = static_cast<RecordType>(type);
+    if ((present & 1) && !getString(record.className))
+        return 0;
+    if ((present & 2) && !getString(record.name))
+        return 0;
+    const auto getSize = [&get](std::optional<float> &value) {
+        float bound = 0.0f;
+        if (!get(&bound, sizeof(bound)))
+            return false;
+        value = bound;
+        return true;
+    };
+    if ((present & 4) && !getSize(record.minSize))
+        return 0;
+    if ((present & 8) && !getSize(record.maxSize))
+        return 0;
+    return in == end ? frameHeaderSize + length : 0;
+}
+}  // namespace wal
+
+/**
+ * @brief When appended records are forced to stable storage
+ */
+enum class SyncPolicy
+{
+    none,      ///< Leave flushing to the operating system
+    onCommit,  ///< fdatasync after every group commit
+    periodic   ///< fdatasync after every syncInterval group commits
+};
+
+/**
+ * @brief Append-only file of operation log records with group commit
+ *
+ * Records are collected in memory and written with a single write call per commit, so all records
+ * of one commit reach the file together.
+ */
+class WriteAheadLog
+{
+public:
+    WriteAheadLog() : fd_(-1), buffer_(), size_(0), policy_(SyncPolicy::onCommit), syncInterval_(1), unsyncedCommits_(0) {}
+
+    WriteAheadLog(const WriteAheadLog &) = delete;
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+    ~WriteAheadLog() { close(); }
+
+    /**
+     * @brief Open a log file for appending, creating it if needed
+     * @param path Log file
+     * @param policy When commits are forced to stable storage
+     * @param syncInterval Commits per fdatasync for SyncPolicy::periodic
+     * @return true if the file was opened, false otherwise
+     */
+    bool open(const std::string &path, SyncPolicy policy, std::size_t syncInterval)
+    {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            return false;
+
+        const auto end = ::lseek(fd_, 0, SEEK_END);
+        size_ = end < 0 ? 0 : static_cast<std::size_t>(end);
+        policy_ = policy;
+        syncInterval_ = syncInterval ? syncInterval : 1;
+        unsyncedCommits_ = 0;
+        return true;
+    }
+
+    /**
+     * @brief Write pending records, sync them as the policy requires and close the file
+     */
+    void close()
+    {
+        if (fd_ < 0)
+            return;
+        commit();
+        if (policy_ != SyncPolicy::none && unsyncedCommits_)
+            ::fdatasync(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /**
+     * @brief Size of the log file including pending records
+     */
+    std::size_t size() const { return size_ + buffer_.size(); }
+
+    void append(const wal::Record &record) { wal::encode(buffer_, record); }
+
+    /**
+     * @brief Write all pending records with one write call
+     * @return true if the records were written (and synced when the policy requires it), false otherwise
+     */
+    bool commit()
+    {
+        if (fd_ < 0 || buffer_.empty())
+            return fd_ >= 0;
+
+        std::size_t written = 0;
+        while (written < buffer_.size())
+        {
+            const auto result = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false;
+            written += static_cast<std::size_t>(result);
+        }
+        size_ += buffer_.size();
+        buffer_.clear();
+
+        ++unsyncedCommits_;
+        if (policy_ == SyncPolicy::onCommit || (policy_ == SyncPolicy::periodic && unsyncedCommits_ >= syncInterval_))
+        {
+            unsyncedCommits_ = 0;
+            return ::fdatasync(fd_) == 0;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read every intact record of a log file
+     * @param path Log file
+     * @param apply Callable taking a const wal::Record &, returning false to stop
+     * @return true if all intact records were applied, false if the file is missing or apply failed
+     */
+    template <typename Apply>
+    static bool replay(const std::string &path, Apply &&apply)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            return false;
+
+        wal::Record record{};
+        std::size_t offset = 0;
+        while (offset < file.size())
+        {
+            const auto frameSize = wal::decode(file.data() + offset, file.size() - offset, record);
+            if (!frameSize)
+                break;
+            if (!apply(static_cast<const wal::Record &>(record)))
+                return false;
+            offset += frameSize;
+        }
+        return true;
+    }
+
+private:
+    int fd_;                       ///< Log file descriptor, -1 if closed
+    std::string buffer_;           ///< Records of the current group commit
+    std::size_t size_;             ///< Bytes written to the file
+    SyncPolicy policy_;            ///< When commits are synced
+    std::size_t syncInterval_;     ///< Commits per sync for SyncPolicy::periodic
+    std::size_t unsyncedCommits_;  ///< Commits written since the last sync
+};
+
+}  // namespace warehouse
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <Departments/Occupancy.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Offline bin packing of a whole delivery over the free space of the departments
+ *
+ * Items are placed first fit decreasing: the largest items first, each in the first compatible
+ * department in warehouse order with room for it. Items left over then get a bounded local search
+ * that moves one already placed item of a full department to another of its own compatible
+ * departments whenever that makes room. An item is only ever assigned to one of its candidates.
+ */
+class BatchPacker
+{
+public:
+    static constexpr std::uint32_t noDepartment = static_cast<std::uint32_t>(-1);  ///< Assignment of an unplaced item
+    static constexpr std::size_t defaultSearchBudget = std::size_t{1} << 16;       ///< Moves evaluated by the local search
+
+    /**
+     * @brief Space left in a department before the delivery
+     */
+    struct Bin
+    {
+        OccupancyUnits freeUnits;  ///< Free space
+        float maxItemSize;         ///< Largest item the department takes
+    };
+
+    /**
+     * @brief One product of the delivery
+     */
+    struct Item
+    {
+        OccupancyUnits units;                         ///< Size in occupancy units
+        float size;                                   ///< Size as reported by the product
+        const std::vector<std::uint32_t> *candidates;  ///< Compatible departments in warehouse order, never nullptr
+    };
+
+    /**
+     * @brief Construct a packer over the departments of a warehouse
+     * @param bins One bin per department, in warehouse order
+     * @param searchBudget Moves the local search may evaluate, 0 to run first fit decreasing only
+     */
+    explicit BatchPacker(std::vector<Bin> bins, std::size_t searchBudget = defaultSearchBudget) :
+            bins_(std::move(bins)), searchBudget_(searchBudget), contents_(bins_.size())
+    {}
+
+    /**
+     * @brief Assign every item to a department
+     * @param items Delivery items
+     * @return Department per item, noDepartment for items that do not fit
+     */
+    std::vector<std::uint32_t> pack(const std::vector<Item> &items)
+    {
+        std::vector<std::uint32_t> assigned(items.size(), noDepartment);
+        std::vector<std::size_t> order(items.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        // Largest first, the most constrained of equally sized items first, then delivery order
+        std::sort(order.begin(), order.end(), [&items](std::size_t a, std::size_t b) {
+            if (items[a].units != items[b].units)
+                return items[a].units > items[b].units;
+            if (items[a].candidates->size() != items[b].candidates->size())
+                return items[a].candidates->size() < items[b].candidates->size();
+            return a < b;
+        });
+
+        std::vector<std::size_t> unplaced{};
+        for (const auto item : order)
+        {
+            for (const auto department : *items[item].candidates)
+            {
+                if (fits(items[item], department))
+                {
+                    place(assigned, items, item, department);
+                    break;
+                }
+            }
+            if (assigned[item] == noDepartment)
+                unplaced.push_back(item);
+        }
+
+        auto budget = searchBudget_;
+        for (const auto item : unplaced)
+        {
+            if (budget == 0)
+                break;
+            makeRoom(assigned, items, item, budget);
+        }
+        return assigned;
+    }
+
+private:
+    bool fits(const Item &item, std::uint32_t department) const
+    {
+        const auto &bin = bins_[department];
+        return item.size <= bin.maxItemSize && item.units <= bin.freeUnits;
+    }
+
+    void place(std::vector<std::uint32_t> &assigned, const std::vector<Item> &items, std::size_t item, std::uint32_t department)
+    {
+        assigned[item] = department;
+        bins_[department].freeUnits -= items[item].units;
+        contents_[department].push_back(item);
+    }
+
+    void remove(std::vector<std::uint32_t> &assigned, const std::vector<Item> &items, std::size_t item)
+    {
+        auto &content = contents_[assigned[item]];
+        *std::find(content.begin(), content.end(), item) = content.back();
+        content.pop_back();
+        bins_[assigned[item]].freeUnits += items[item].units;
+        assigned[item] = noDepartment;
+    }
+
+    /**
+     * @brief Place an unplaced item by moving one placed item out of the way
+     *
+     * The first candidate department holding an item that is large enough to make room and fits in
+     * one of its other candidates wins.
+     */
+    void makeRoom(std::vector<std::uint32_t> &assigned, const std::vector<Item> &items, std::size_t item, std::size_t &budget)
+    {
+        for (const auto department : *items[item].candidates)
+        {
+            if (items[item].size > bins_[department].maxItemSize)
+                continue;
+            if (fits(items[item], department))
+            {
+                place(assigned, items, item, department);
+                return;
+            }
+
+            const auto missing = items[item].units - bins_[department].freeUnits;
+            for (std::size_t i = 0; i < contents_[department].size(); ++i)
+            {
+                const auto moved = contents_[department][i];
+                if (items[moved].units < missing)
+                    continue;
+                for (const auto target : *items[moved].candidates)
+                {
+                    if (budget == 0)
+                        return;
+                    --budget;
+                    if (target == department || !fits(items[moved], target))
+                        continue;
+                    remove(assigned, items, moved);
+                    place(assigned, items, moved, target);
+                    place(assigned, items, item, department);
+                    return;
+                }
+            }
+        }
+    }
+
+    std::vector<Bin> bins_;                           ///< Departments with the space the plan leaves
+    std::size_t searchBudget_;                        ///< Moves the local search may evaluate
+    std::vector<std::vector<std::size_t>> contents_;  ///< Items planned per department
+};
+
+}  // namespace warehouse
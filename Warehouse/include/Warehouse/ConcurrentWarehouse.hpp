@@ -0,0 +1,417 @@
+#pragma once
+
+#include <PicoJson/picojson.h>
+
+#include <Interfaces/IDepartment.hpp>
+#include <Interfaces/IWarehouse.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Departments/BaseDepartment.hpp"
+#include "Departments/ConcurrentHazardousDepartment.hpp"
+#include "Departments/ConcurrentSpecialDepartment.hpp"
+#include "Departments/LockFreeDepartment.hpp"
+#include "Serialization/JsonSink.hpp"
+#include "Warehouse/DepartmentRouter.hpp"
+#include "Warehouse/OrderBatch.hpp"
+#include "Warehouse/Warehouse.h"
+
+namespace warehouse
+{
+
+/**
+ * @brief Warehouse that serves deliveries, orders and reports from many threads at once
+ *
+ * Every department has a mutex of its own: a delivery locks only the departments it tries, in
+ * first-fit order, and an order locks one department at a time while it looks for each line.
+ * Occupancy is published per department after every change, so getOccupancyReport() reads it
+ * without taking any lock. Adding departments and loading a state swap in a new department layout
+ * under an exclusive lock. Layouts are shared: a replaced layout and the departments only it
+ * holds are destroyed when the last reader still using it lets go.
+ *
+ * Departments deriving from ConcurrentDepartment (ConcurrentHazardousDepartment,
+ * ConcurrentSpecialDepartment) are never locked: deliveries and orders call them directly and the
+ * report reads their own occupancy. They serialize under the class names of their mutex-backed
+ * counterparts, a warehouse loading states of lock-free departments is constructed with
+ * lockFreeDepartmentFactory().
+ *
+ * Placement follows the same first-fit rule as Warehouse, evaluated against the occupancy each
+ * department has when the delivery reaches it. The warehouse is not journaled.
+ */
+class ConcurrentWarehouse : public warehouseInterface::IWarehouse
+{
+public:
+    ConcurrentWarehouse() : ConcurrentWarehouse(nullptr) {}
+
+    /**
+     * @brief Construct a warehouse creating the departments of loaded states with a factory
+     * @param departmentFactory Department factory, nullptr for Warehouse::makeDepartment()
+     */
+    explicit ConcurrentWarehouse(DepartmentFactory departmentFactory) :
+            structureMutex_(), layout_(std::make_shared<const Layout>()), departmentFactory_(std::move(departmentFactory))
+    {}
+
+    ConcurrentWarehouse(const ConcurrentWarehouse &) = delete;
+    ConcurrentWarehouse &operator=(const ConcurrentWarehouse &) = delete;
+
+    void addDepartment(warehouseInterface::IDepartmentPtr department) override
+    {
+        if (!department)
+            return;
+
+        std::unique_lock<std::shared_mutex> lock(structureMutex_);
+        auto layout = std::make_shared<Layout>(*std::atomic_load(&layout_));
+        layout->add(std::make_shared<Slot>(std::move(department)));
+        publish(std::move(layout));
+    }
+
+    warehouseInterface::DeliveryReportJson newDelivery(std::vector<warehouseInterface::IProductPtr> products) override
+    {
+        std::shared_lock<std::shared_mutex> lock(structureMutex_);
+        const auto layout = std::atomic_load(&layout_);
+        picojson::array report;
+
+        for (auto &product : products)
+        {
+            if (!product)
+                continue;
+
+            picojson::object delivery;
+            delivery["productName"] = picojson::value(product->name());
+
+            const float size = product->itemSize();
+            const Slot *assigned = nullptr;
+            for (auto *slot : layout->router.candidates(product->itemFlags()))
+            {
+                // Full departments are skipped without locking, the check is repeated under the lock
+                if (!slot->mightFit(size))
+                    continue;
+
+                if (slot->lockFree)
+                {
+                    if (!slot->lockFree->tryAddItem(product))
+                        continue;
+                    assigned = slot;
+                    break;
+                }
+
+                std::lock_guard<std::mutex> departmentLock(slot->mutex);
+                if (!DepartmentRouter::hasRoomFor(*slot->department, size))
+                    continue;
+
+                const bool added = slot->department->addItem(std::move(product));
+                slot->publishOccupancy();
+                if (added)
+                {
+                    assigned = slot;
+                    break;
+                }
+            }
+
+            if (assigned)
+            {
+                delivery["status"] = picojson::value("Success");
+                delivery["assignedDepartment"] = picojson::value(assigned->name);
+                delivery["errorLog"] = picojson::value("");
+            }
+            else
+            {
+                delivery["status"] = picojson::value("Fail");
+                delivery["assignedDepartment"] = picojson::value("None");
+                delivery["errorLog"] = picojson::value("Warehouse cannot store this product. Lack of space in departments.");
+            }
+
+            report.push_back(picojson::value(delivery));
+        }
+
+        picojson::object result;
+        result["deliveryReport"] = picojson::value(report);
+        return picojson::value(result).serialize();
+    }
+
+    warehouseInterface::Order newOrder(const warehouseInterface::OrderJson &orderJson) override
+    {
+        warehouseInterface::Order order{std::vector<warehouseInterface::IProductPtr>{}, orderJson};
+
+        picojson::value val;
+        picojson::parse(val, orderJson);
+        const auto &obj = val.get<picojson::object>();
+        const auto &orderArray = obj.at("order").get<picojson::array>();
+
+        std::shared_lock<std::shared_mutex> lock(structureMutex_);
+        const auto layout = std::atomic_load(&layout_);
+        for (const auto &item : orderArray)
+        {
+            const auto &itemObj = item.get<picojson::object>();
+            const auto query = ProductQuery::fromJson(itemObj);
+            const auto symbols = query.symbols();
+            std::string itemJson{};
+
+            for (const auto &slot : layout->slots)
+            {
+                warehouseInterface::IProductPtr product{};
+                if (slot->lockFree)
+                {
+                    product = slot->lockFree->takeItem(query, symbols);
+                }
+                else
+                {
+                    std::lock_guard<std::mutex> departmentLock(slot->mutex);
+                    if (slot->base)
+                    {
+                        product = slot->base->takeItem(query, symbols);
+                    }
+                    else
+                    {
+                        if (itemJson.empty())
+                            itemJson = picojson::value(itemObj).serialize();
+                        product = slot->department->getItem(itemJson);
+                    }
+                    if (product)
+                        slot->publishOccupancy();
+                }
+
+                if (product)
+                {
+                    order.products.push_back(std::move(product));
+                    break;
+                }
+            }
+        }
+        return order;
+    }
+
+    /**
+     * @brief Serve a wave of orders, each department is locked once for the whole wave
+     *
+     * The orders are parsed before any lock is taken. Within the wave, earlier orders take items first
+     * as if newOrder() was called for each of them in turn, other calls may interleave between departments.
+     *
+     * @param orders Serialized orders
+     * @return One order per entry of orders, in the same order
+     */
+    std::vector<warehouseInterface::Order> newOrders(const std::vector<warehouseInterface::OrderJson> &orders)
+    {
+        OrderBatch batch(orders);
+
+        std::shared_lock<std::shared_mutex> lock(structureMutex_);
+        const auto layout = std::atomic_load(&layout_);
+        for (std::size_t i = 0; i < layout->slots.size() && !batch.done(); ++i)
+        {
+            auto *slot = layout->slots[i].get();
+            const auto take = [slot](OrderBatch::Line &line) {
+                if (slot->lockFree)
+                    return slot->lockFree->takeItem(line.query, line.symbols);
+                if (slot->base)
+                    return slot->base->takeItem(line.query, line.symbols);
+                return slot->department->getItem(line.serializedDescription());
+            };
+
+            if (slot->lockFree)
+            {
+                batch.visitDepartment(static_cast<std::uint32_t>(i), take);
+                continue;
+            }
+            std::lock_guard<std::mutex> departmentLock(slot->mutex);
+            batch.visitDepartment(static_cast<std::uint32_t>(i), take);
+            slot->publishOccupancy();
+        }
+        return batch.release();
+    }
+
+    warehouseInterface::OccupancyReportJson getOccupancyReport() const override
+    {
+        picojson::array departmentsOccupancy;
+
+        // The layout is held until the report is written, a concurrent load cannot free its departments
+        const auto layout = std::atomic_load(&layout_);
+        for (const auto &slot : layout->slots)
+        {
+            picojson::object dept;
+            dept["departmentName"] = picojson::value(slot->name);
+            dept["maxOccupancy"] = picojson::value(slot->maxOccupancy);
+            dept["occupancy"] = picojson::value(slot->currentOccupancy());
+            departmentsOccupancy.push_back(picojson::value(dept));
+        }
+
+        picojson::object result;
+        result["departmentsOccupancy"] = picojson::value(departmentsOccupancy);
+        return picojson::value(result).serialize();
+    }
+
+    /**
+     * @brief Serialize the warehouse, deliveries and orders wait for the whole call so the state is consistent
+     *
+     * The structure lock is taken exclusively: lock-free departments have no lock of their own to hold.
+     */
+    warehouseInterface::WarehouseStateJson saveWarehouseState() const override
+    {
+        std::unique_lock<std::shared_mutex> lock(structureMutex_);
+        const auto layout = std::atomic_load(&layout_);
+
+        JsonSink sink;
+        sink.beginObject();
+        sink.key("warehouseState");
+        sink.beginArray();
+        for (const auto &slot : layout->slots)
+            Warehouse::writeDepartmentJson(sink, *slot->department, slot->base);
+        sink.endArray();
+        sink.endObject();
+        return sink.release();
+    }
+
+    /**
+     * @brief Replace every department by the ones of a serialized state
+     *
+     * The state is parsed by a Warehouse before any lock is taken, an invalid state leaves the
+     * warehouse untouched. Departments are created by the factory of the warehouse.
+     */
+    bool loadWarehouseState(const warehouseInterface::WarehouseStateJson &stateJson) override
+    {
+        Warehouse loaded{};
+        loaded.setDepartmentFactory(departmentFactory_);
+        if (!loaded.loadWarehouseState(stateJson))
+            return false;
+
+        auto layout = std::make_shared<Layout>();
+        for (auto &department : loaded.releaseDepartments())
+            layout->add(std::make_shared<Slot>(std::move(department)));
+
+        std::unique_lock<std::shared_mutex> lock(structureMutex_);
+        publish(std::move(layout));
+        return true;
+    }
+
+    /**
+     * @brief Department factory restoring HazardousDepartment and SpecialDepartment as their lock-free variants
+     * @param capacity Item capacity of the lock-free departments, items of a loaded state beyond it are dropped
+     */
+    static DepartmentFactory lockFreeDepartmentFactory(std::size_t capacity = ConcurrentHazardousDepartment::defaultCapacity)
+    {
+        return [capacity](const std::string &className, float maxOccupancy) -> warehouseInterface::IDepartmentPtr {
+            if (className == "HazardousDepartment")
+                return std::make_unique<ConcurrentHazardousDepartment>(maxOccupancy, capacity);
+            if (className == "SpecialDepartment")
+                return std::make_unique<ConcurrentSpecialDepartment>(maxOccupancy, capacity);
+            return Warehouse::makeDepartment(className, maxOccupancy);
+        };
+    }
+
+    /**
+     * @brief Visit the departments in warehouse order
+     * @param visit Callable taking a const warehouseInterface::IDepartment &, called under the shared structure lock
+     */
+    template <typename Visitor>
+    void forEachDepartment(Visitor &&visit) const
+    {
+        std::shared_lock<std::shared_mutex> lock(structureMutex_);
+        const auto layout = std::atomic_load(&layout_);
+        for (const auto &slot : layout->slots)
+            visit(static_cast<const warehouseInterface::IDepartment &>(*slot->department));
+    }
+
+private:
+    /**
+     * @brief A department with its lock and the figures read without the lock
+     */
+    struct Slot
+    {
+        explicit Slot(warehouseInterface::IDepartmentPtr owned) :
+                department(std::move(owned)),
+                base(dynamic_cast<BaseDepartment *>(department.get())),
+                lockFree(dynamic_cast<ConcurrentDepartment *>(department.get())),
+                mutex(),
+                name(department->departmentName()),
+                maxOccupancy(department->getMaxOccupancy()),
+                maxOccupancyUnits(toOccupancyUnits(maxOccupancy)),
+                maxItemSize(department->getMaxItemSize()),
+                supportedFlags(department->getSupportedFlags()),
+                occupancy(departmentOccupancy())
+        {}
+
+        Slot(const Slot &) = delete;
+        Slot &operator=(const Slot &) = delete;
+
+        warehouseInterface::ProductLabelFlags getSupportedFlags() const { return supportedFlags; }
+
+        /**
+         * @brief Check the size limits against the last published occupancy
+         */
+        bool mightFit(float size) const
+        {
+            return size <= maxItemSize && toOccupancyUnits(size) <= maxOccupancyUnits - currentOccupancyUnits();
+        }
+
+        /**
+         * @brief Occupancy for lock-free readers, lock-free departments are asked directly
+         */
+        OccupancyUnits currentOccupancyUnits() const
+        {
+            return lockFree ? lockFree->occupancyUnits() : occupancy.load(std::memory_order_relaxed);
+        }
+
+        float currentOccupancy() const { return fromOccupancyUnits(currentOccupancyUnits()); }
+
+        /**
+         * @brief Get the occupancy of the department, exact for library departments, called with mutex held
+         */
+        OccupancyUnits departmentOccupancy() const
+        {
+            if (base)
+                return base->occupancyUnits();
+            if (lockFree)
+                return lockFree->occupancyUnits();
+            return toOccupancyUnits(department->getOccupancy());
+        }
+
+        /**
+         * @brief Make the occupancy of the department visible to lock-free readers, called with mutex held
+         */
+        void publishOccupancy() { occupancy.store(departmentOccupancy(), std::memory_order_relaxed); }
+
+        warehouseInterface::IDepartmentPtr department;               ///< Stored department
+        BaseDepartment *base;                                        ///< department if it derives from BaseDepartment
+        ConcurrentDepartment *lockFree;                              ///< department if it is used without mutex
+        mutable std::mutex mutex;                                    ///< Guards department unless it is lockFree
+        const std::string name;                                      ///< Department name for reports
+        const float maxOccupancy;                                    ///< Maximum occupancy for reports
+        const OccupancyUnits maxOccupancyUnits;                      ///< Maximum occupancy for the unlocked size check
+        const float maxItemSize;                                     ///< Maximum item size for the unlocked size check
+        const warehouseInterface::ProductLabelFlags supportedFlags;  ///< Supported flags for routing
+        std::atomic<OccupancyUnits> occupancy;                       ///< Occupancy published after every change
+    };
+
+    /**
+     * @brief Departments in warehouse order with their delivery routes, never changed once published
+     *
+     * Slots are shared by the layouts that list them, the router points into them.
+     */
+    struct Layout
+    {
+        std::vector<std::shared_ptr<Slot>> slots{};
+        BasicDepartmentRouter<Slot *> router{};
+
+        void add(std::shared_ptr<Slot> slot)
+        {
+            router.addDepartment(slot.get());
+            slots.push_back(std::move(slot));
+        }
+    };
+
+    /**
+     * @brief Make a layout current, called with the exclusive structure lock held
+     */
+    void publish(std::shared_ptr<const Layout> layout) { std::atomic_store(&layout_, std::move(layout)); }
+
+    mutable std::shared_mutex structureMutex_;  ///< Exclusive while the layout changes, shared while departments are used
+    std::shared_ptr<const Layout> layout_;      ///< Current layout, accessed with std::atomic_load and std::atomic_store only
+    const DepartmentFactory departmentFactory_;  ///< Creates the departments of loaded states
+};
+
+}  // namespace warehouse
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Interfaces/IDepartment.hpp>
+#include <Interfaces/ProductFlags.hpp>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Departments/BaseDepartment.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief Flag-indexed routing table for product deliveries
+ *
+ * Every 8-bit ProductLabelFlags mask owns a bucket with the departments whose supported flags
+ * cover that mask. Buckets keep the departments in the order they were added to the warehouse,
+ * so walking a bucket preserves the first-fit placement rule while skipping departments that
+ * could never accept the product.
+ *
+ * @tparam Target Pointer to anything with getSupportedFlags(), usually an IDepartment
+ */
+template <typename Target>
+class BasicDepartmentRouter
+{
+public:
+    using Bucket = std::vector<Target>;
+
+    static constexpr std::size_t bucketsCount = 256;  ///< One bucket per 8-bit flags mask
+
+    /**
+     * @brief Append a department to every bucket its supported flags cover
+     * @param department Department owned by the warehouse, nullptr is ignored
+     */
+    void addDepartment(Target department)
+    {
+        if (!department)
+            return;
+
+        const auto supported = static_cast<unsigned>(department->getSupportedFlags());
+        for (std::size_t mask = 0; mask < bucketsCount; ++mask)
+        {
+            if ((mask & supported) == mask)
+                buckets_[mask].push_back(department);
+        }
+    }
+
+    /**
+     * @brief Rebuild all buckets from scratch
+     * @param departments Departments in warehouse order
+     */
+    void rebuild(const std::vector<warehouseInterface::IDepartmentPtr> &departments)
+    {
+        clear();
+        for (const auto &department : departments)
+        {
+            addDepartment(department.get());
+        }
+    }
+
+    /**
+     * @brief Remove all departments from the routing table
+     */
+    void clear()
+    {
+        for (auto &bucket : buckets_)
+        {
+            bucket.clear();
+        }
+    }
+
+    /**
+     * @brief Get the departments that may store a product with the given flags
+     * @param flags Product flags
+     * @return Departments in first-fit order, empty if the flags do not fit in the 8-bit mask
+     */
+    const Bucket &candidates(warehouseInterface::ProductLabelFlags flags) const
+    {
+        const auto mask = static_cast<unsigned>(flags);
+        if (mask >= bucketsCount)
+            return noCandidates_;
+        return buckets_[mask];
+    }
+
+    /**
+     * @brief Check the size limits of a department without handing over the product
+     *
+     * IDepartment::addItem takes ownership even when it rejects a product, so the warehouse asks
+     * this first and only moves the product into a department that will keep it. Library departments
+     * are checked against their exact occupancy, the answer must match the check made by addItem.
+     *
+     * @param department Candidate department
+     * @param size Product size
+     * @return true if the product size fits the department limits and free space
+     */
+    static bool hasRoomFor(const warehouseInterface::IDepartment &department, float size)
+    {
+        if (const auto *base = dynamic_cast<const BaseDepartment *>(&department))
+            return base->hasRoomFor(size);
+        return size <= department.getMaxItemSize() && department.getOccupancy() + size <= department.getMaxOccupancy();
+    }
+
+private:
+    std::array<Bucket, bucketsCount> buckets_{};  ///< Departments per flags mask
+    Bucket noCandidates_{};                       ///< Shared empty bucket for unknown flags
+};
+
+using DepartmentRouter = BasicDepartmentRouter<warehouseInterface::IDepartment *>;
+
+}  // namespace warehouse
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <Departments/Occupancy.hpp>
+#include <Interfaces/ProductFlags.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief How a delivery chooses among the departments that can store a product
+ */
+enum class PlacementPolicy
+{
+    firstFit,  ///< The first department in warehouse order with enough space
+    bestFit,   ///< The department left with the least free space, ties go to the earlier department
+    worstFit   ///< The department with the most free space, ties go to the earlier department
+};
+
+/**
+ * @brief Departments indexed by free space for placement
+ *
+ * Departments with the same supported flags form a group, a product is routed to every group whose
+ * flags cover its own, exactly as DepartmentRouter buckets do. For first fit every group keeps a max
+ * segment tree over the free space of its departments in warehouse order, which finds the leftmost
+ * department with enough room. For best fit and worst fit it keeps a balanced tree keyed by free
+ * space. Either way a placement costs O(G log D) for G groups instead of a walk over all D
+ * candidates. Groups never share a department, updates of departments in different groups may run
+ * concurrently.
+ */
+class FitIndex
+{
+public:
+    static constexpr std::uint32_t noDepartment = static_cast<std::uint32_t>(-1);  ///< Result when nothing fits
+
+    FitIndex() : policy_(PlacementPolicy::firstFit), groups_(), groupOf_(), slot_(), free_() {}
+
+    /**
+     * @brief Drop every department and choose the policy served for the next ones
+     */
+    void reset(PlacementPolicy policy)
+    {
+        policy_ = policy;
+        groups_.clear();
+        groupOf_.clear();
+        slot_.clear();
+        free_.clear();
+    }
+
+    /**
+     * @brief Append the next department in warehouse order
+     * @param supportedFlags Supported flags of the department
+     * @param freeUnits Free space of the department
+     */
+    void addDepartment(warehouseInterface::ProductLabelFlags supportedFlags, OccupancyUnits freeUnits)
+    {
+        const auto flags = static_cast<unsigned>(supportedFlags);
+        std::size_t group = 0;
+        while (group < groups_.size() && groups_[group].flags != flags)
+            ++group;
+        if (group == groups_.size())
+            groups_.push_back(Group{flags, {}, {}, {}});
+
+        const auto department = static_cast<std::uint32_t>(free_.size());
+        auto &members = groups_[group].members;
+        groupOf_.push_back(group);
+        slot_.push_back(members.size());
+        free_.push_back(freeUnits);
+        members.push_back(department);
+        if (policy_ != PlacementPolicy::firstFit)
+        {
+            groups_[group].departments.insert(key(department));
+            return;
+        }
+
+        auto &tree = groups_[group].tree;
+        if (members.size() > tree.size() / 2)
+        {
+            // Double the leaves and rebuild, every department is rebuilt O(1) times on average
+            tree.assign(std::max<std::size_t>(2, tree.size()) * 2, noRoom);
+            const auto leaves = tree.size() / 2;
+            for (std::size_t i = 0; i < members.size(); ++i)
+                tree[leaves + i] = free_[members[i]];
+            for (auto node = leaves - 1; node > 0; --node)
+                tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+            return;
+        }
+        setLeaf(tree, slot_[department], freeUnits);
+    }
+
+    /**
+     * @brief Move a department to its new free space
+     * @param department Index of the department in warehouse order
+     * @param freeUnits Free space of the department
+     */
+    void update(std::uint32_t department, OccupancyUnits freeUnits)
+    {
+        if (free_[department] == freeUnits)
+            return;
+        auto &group = groups_[groupOf_[department]];
+        if (policy_ == PlacementPolicy::firstFit)
+        {
+            free_[department] = freeUnits;
+            setLeaf(group.tree, slot_[department], freeUnits);
+            return;
+        }
+        group.departments.erase(key(department));
+        free_[department] = freeUnits;
+        group.departments.insert(key(department));
+    }
+
+    /**
+     * @brief Find the department the policy places a product in
+     * @param flags Product flags
+     * @param size Product size
+     * @param fits Callable taking a department index and checking its remaining limits, such as the maximum item size
+     * @return Index of the chosen department, noDepartment if none has room
+     */
+    template <typename Fits>
+    std::uint32_t select(warehouseInterface::ProductLabelFlags flags, OccupancyUnits size, Fits &&fits) const
+    {
+        const auto mask = static_cast<unsigned>(flags);
+        if (policy_ == PlacementPolicy::firstFit)
+        {
+            auto first = noDepartment;
+            for (const auto &group : groups_)
+            {
+                if ((mask & group.flags) != mask)
+                    continue;
+                for (auto slot = leftmost(group.tree, 1, 0, group.tree.size() / 2, 0, size);
+                     slot < group.members.size() && group.members[slot] < first;
+                     slot = leftmost(group.tree, 1, 0, group.tree.size() / 2, slot + 1, size))
+                {
+                    if (fits(group.members[slot]))
+                    {
+                        first = group.members[slot];
+                        break;
+                    }
+                }
+            }
+            return first;
+        }
+
+        const Key *best = nullptr;
+        for (const auto &group : groups_)
+        {
+            if ((mask & group.flags) != mask)
+                continue;
+
+            // Best fit starts at the smallest free space holding the product, worst fit at the largest
+            auto it = policy_ == PlacementPolicy::bestFit ? group.departments.lower_bound(Key{size, 0}) : group.departments.begin();
+            for (; it != group.departments.end() && (!best || *it < *best); ++it)
+            {
+                if (free_[it->second] < size)
+                    break;
+                if (fits(it->second))
+                {
+                    best = &*it;
+                    break;
+                }
+            }
+        }
+        return best ? best->second : noDepartment;
+    }
+
+private:
+    using Key = std::pair<OccupancyUnits, std::uint32_t>;  ///< Rank of the free space, department index
+
+    static constexpr OccupancyUnits noRoom = std::numeric_limits<OccupancyUnits>::min();  ///< Free space of unused leaves
+    static constexpr std::size_t noSlot = static_cast<std::size_t>(-1);                    ///< leftmost() found nothing
+
+    /**
+     * @brief Departments sharing their supported flags
+     */
+    struct Group
+    {
+        unsigned flags;                      ///< Supported flags of every department in the group
+        std::vector<std::uint32_t> members;  ///< Departments in warehouse order
+        std::vector<OccupancyUnits> tree;    ///< First fit: max free space per node, node 1 is the root, leaves follow members
+        std::set<Key> departments;           ///< Best and worst fit: departments ordered by key()
+    };
+
+    static void setLeaf(std::vector<OccupancyUnits> &tree, std::size_t slot, OccupancyUnits freeUnits)
+    {
+        auto node = tree.size() / 2 + slot;
+        tree[node] = freeUnits;
+        for (node /= 2; node > 0; node /= 2)
+            tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+    }
+
+    /**
+     * @brief Find the leftmost slot at or after from with at least size free in the subtree of node covering [begin, end)
+     */
+    static std::size_t leftmost(const std::vector<OccupancyUnits> &tree,
+                                std::size_t node,
+                                std::size_t begin,
+                                std::size_t end,
+                                std::size_t from,
+                                OccupancyUnits size)
+    {
+        if (end <= from || tree.empty() || tree[node] < size)
+            return noSlot;
+        if (end - begin == 1)
+            return begin;
+        const auto middle = begin + (end - begin) / 2;
+        const auto slot = leftmost(tree, 2 * node, begin, middle, from, size);
+        return slot != noSlot ? slot : leftmost(tree, 2 * node + 1, middle, end, from, size);
+    }
+
+    /**
+     * @brief Order departments by free space, ascending for best fit and descending for worst fit
+     */
+    Key key(std::uint32_t department) const
+    {
+        return {policy_ == PlacementPolicy::bestFit ? free_[department] : -free_[department], department};
+    }
+
+    PlacementPolicy policy_;            ///< Policy the groups are indexed for
+    std::vector<Group> groups_;         ///< Groups in order of their first department
+    std::vector<std::size_t> groupOf_;  ///< Group per department
+    std::vector<std::size_t> slot_;     ///< Position per department within the members of its group
+    std::vector<OccupancyUnits> free_;  ///< Free space per department, as indexed in its group
+};
+
+}  // namespace warehouse
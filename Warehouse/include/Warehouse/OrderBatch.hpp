@@ -0,0 +1,164 @@
+#pragma once
+
+#include <PicoJson/picojson.h>
+
+#include <Interfaces/Aliases.hpp>
+#include <Interfaces/IProduct.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Departments/ProductQuery.hpp"
+#include "Warehouse/TaskScheduler.hpp"
+
+namespace warehouse
+{
+
+/**
+ * @brief A wave of orders parsed into lines that are offered to one department at a time
+ *
+ * A line is taken from the first department holding a match, as in a newOrder() call per order.
+ * Departments are visited in warehouse order and each one sees the lines still open in batch order,
+ * so a department serves the same lines in the same order as it would for the orders one by one:
+ * orders earlier in the batch take items first.
+ */
+class OrderBatch
+{
+public:
+    /**
+     * @brief One requested product
+     */
+    struct Line
+    {
+        ProductQuery query{};                                 ///< Requested class and name
+        SymbolQuery symbols{};                                ///< query.symbols()
+        const picojson::object *description = nullptr;        ///< Parsed line, owned by the batch
+        std::string descriptionJson{};                        ///< *description serialized on first use, see serializedDescription()
+        std::uint32_t department = noDepartment;              ///< Index of the department the product was taken from
+        warehouseInterface::IProductPtr product{};            ///< Taken product, nullptr while the line is open
+
+        Line() = default;
+        Line(const Line &) = delete;
+        Line &operator=(const Line &) = delete;
+        Line(Line &&) = default;
+        Line &operator=(Line &&) = default;
+
+        /**
+         * @brief Get the line as a serialized product description for departments outside this library
+         */
+        const std::string &serializedDescription()
+        {
+            if (descriptionJson.empty())
+                descriptionJson = picojson::value(*description).serialize();
+            return descriptionJson;
+        }
+    };
+
+    static constexpr std::uint32_t noDepartment = static_cast<std::uint32_t>(-1);  ///< Department of an open line
+
+    /**
+     * @brief Parse a wave of orders
+     * @param orders Serialized orders, each with an "order" array of product descriptions
+     * @param scheduler Scheduler parsing the orders in parallel, nullptr to parse them on the calling thread
+     * @throw std::out_of_range or std::runtime_error for a malformed order, as newOrder() throws, after
+     *        the parsing tasks on the scheduler have finished
+     */
+    explicit OrderBatch(const std::vector<warehouseInterface::OrderJson> &orders, TaskScheduler *scheduler = nullptr) :
+            receipts_(orders), parsed_(orders.size()), lines_(), firstLine_(), open_()
+    {
+        std::vector<std::vector<Line>> orderLines(orders.size());
+        const auto parse = [this, &orderLines](std::size_t i) {
+            picojson::parse(parsed_[i], receipts_[i]);
+            for (const auto &item : parsed_[i].get<picojson::object>().at("order").get<picojson::array>())
+            {
+                Line line{};
+                line.description = &item.get<picojson::object>();
+                line.query = ProductQuery::fromJson(*line.description);
+                line.symbols = line.query.symbols();
+                orderLines[i].push_back(std::move(line));
+            }
+        };
+        if (scheduler)
+            scheduler->parallelFor(orders.size(), parse);
+        else
+            for (std::size_t i = 0; i < orders.size(); ++i)
+                parse(i);
+
+        for (auto &order : orderLines)
+        {
+            firstLine_.push_back(lines_.size());
+            for (auto &line : order)
+                lines_.push_back(std::move(line));
+        }
+        firstLine_.push_back(lines_.size());
+
+        open_.reserve(lines_.size());
+        for (std::size_t i = 0; i < lines_.size(); ++i)
+            open_.push_back(i);
+    }
+
+    OrderBatch(const OrderBatch &) = delete;
+    OrderBatch &operator=(const OrderBatch &) = delete;
+
+    /**
+     * @brief Check whether every line was served
+     */
+    bool done() const { return open_.empty(); }
+
+    /**
+     * @brief Offer the open lines to one department in batch order
+     * @param department Index of the department, recorded in the lines it serves
+     * @param take Callable taking a Line & and returning the taken product or nullptr
+     */
+    template <typename Take>
+    void visitDepartment(std::uint32_t department, Take &&take)
+    {
+        std::size_t kept = 0;
+        for (const auto index : open_)
+        {
+            auto &line = lines_[index];
+            line.product = take(line);
+            if (line.product)
+                line.department = department;
+            else
+                open_[kept++] = index;
+        }
+        open_.resize(kept);
+    }
+
+    /**
+     * @brief Get every line in batch order
+     */
+    const std::vector<Line> &lines() const { return lines_; }
+
+    /**
+     * @brief Hand over the orders with the products of their served lines, in line order
+     */
+    std::vector<warehouseInterface::Order> release()
+    {
+        std::vector<warehouseInterface::Order> orders{};
+        orders.reserve(receipts_.size());
+        for (std::size_t i = 0; i < receipts_.size(); ++i)
+        {
+            warehouseInterface::Order order{std::vector<warehouseInterface::IProductPtr>{}, receipts_[i]};
+            for (auto line = firstLine_[i]; line < firstLine_[i + 1]; ++line)
+            {
+                if (lines_[line].product)
+                    order.products.push_back(std::move(lines_[line].product));
+            }
+            orders.push_back(std::move(order));
+        }
+        return orders;
+    }
+
+private:
+    const std::vector<warehouseInterface::OrderJson> &receipts_;  ///< Serialized orders, owned by the caller
+    std::vector<picojson::value> parsed_;                         ///< Parsed orders, lines point into them
+    std::vector<Line> lines_;                                     ///< Lines of every order in batch order
+    std::vector<std::size_t> firstLine_;                          ///< First line per order, plus the line count
+    std::vector<std::size_t> open_;                               ///< Lines not served yet, in batch order
+};
+
+}  // namespace warehouse
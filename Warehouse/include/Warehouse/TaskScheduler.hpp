@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace warehouse
+{
+
+/**
+ * @brief Work-stealing task scheduler shared by the parallel warehouse operations
+ *
+ * Every worker owns a deque: tasks submitted from a worker go to the back of its own deque and
+ * the worker takes its newest task first, idle workers steal the oldest task of another deque.
+ * Tasks submitted from other threads are spread over the deques round-robin. Threads waiting for
+ * a TaskGroup run queued tasks meanwhile, so tasks may wait for tasks they submitted.
+ */
+class TaskScheduler
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Start the workers
+     * @param threads Number of worker threads, 0 for std::thread::hardware_concurrency()
+     */
+    explicit TaskScheduler(std::size_t threads = 0) :
+            queues_(), workers_(), queued_(0), nextQueue_(0), sleepMutex_(), wake_(), stopping_(false)
+    {
+        if (threads == 0)
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        for (std::size_t i = 0; i < threads; ++i)
+            workers_.emplace_back([this, i]() { work(i); });
+    }
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /**
+     * @brief Stop the workers, tasks still queued are dropped
+     */
+    ~TaskScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_)
+            worker.join();
+    }
+
+    /**
+     * @brief Number of worker threads
+     */
+    std::size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief Queue a task, see TaskGroup for waiting on it
+     *
+     * The task must not throw, TaskGroup::run() hands exceptions to the waiting thread instead.
+     */
+    void submit(Task task)
+    {
+        const auto &current = currentWorker();
+        const auto index = current.scheduler == this ? current.index
+                                                     : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            // Counted first, so queued_ never drops below the number of tasks in the deques
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queued_.fetch_add(1, std::memory_order_release);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * @brief Run one queued task on the calling thread
+     * @return false if no task was queued
+     */
+    bool runOne()
+    {
+        const auto &current = currentWorker();
+        Task task{};
+        if (!take(current.scheduler == this ? current.index : 0, task))
+            return false;
+        task();
+        return true;
+    }
+
+    /**
+     * @brief Run body(i) for every i in [0, count) on the workers and the calling thread
+     *
+     * Indices are handed out in contiguous chunks, a few per worker so uneven chunks balance out.
+     * A chunk stops at the first exception thrown by body, which is rethrown once every chunk ended.
+     * @param count Number of indices
+     * @param body Callable taking a std::size_t index, called from several threads at once
+     */
+    template <typename Body>
+    void parallelFor(std::size_t count, Body &&body);
+
+private:
+    /**
+     * @brief Deque of one worker, the owner uses the back and thieves the front
+     */
+    struct Queue
+    {
+        std::mutex mutex{};
+        std::deque<Task> tasks{};
+    };
+
+    /**
+     * @brief Scheduler and deque of the calling thread, nullptr scheduler outside workers
+     */
+    struct Worker
+    {
+        const TaskScheduler *scheduler = nullptr;
+        std::size_t index = 0;
+    };
+
+    static Worker &currentWorker()
+    {
+        thread_local Worker worker{};
+        return worker;
+    }
+
+    /**
+     * @brief Pop the newest task of deque home, or steal the oldest task of another deque
+     */
+    bool take(std::size_t home, Task &task)
+    {
+        if (queued_.load(std::memory_order_acquire) == 0)
+            return false;
+
+        for (std::size_t i = 0; i < queues_.size(); ++i)
+        {
+            auto &queue = *queues_[(home + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void work(std::size_t index)
+    {
+        currentWorker() = Worker{this, index};
+        for (;;)
+        {
+            Task task{};
+            if (take(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this]() { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;  ///< One deque per worker
+    std::vector<std::thread> workers_;            ///< Worker threads
+    std::atomic<std::size_t> queued_;             ///< Tasks in all deques
+    std::atomic<std::size_t> nextQueue_;          ///< Round-robin deque of the next task submitted from outside
+    std::mutex sleepMutex_;                       ///< Guards stopping_, orders sleeping against submit()
+    std::condition_variable wake_;                ///< Wakes idle workers
+    bool stopping_;                               ///< Workers exit once set
+};
+
+/**
+ * @brief Tasks submitted to a TaskScheduler that are waited for together
+ *
+ * The first exception thrown by a task is kept and rethrown by wait(). The destructor waits for the
+ * tasks that are still running and drops a pending exception.
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskScheduler &scheduler) : scheduler_(scheduler), mutex_(), done_(), pending_(0), error_() {}
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() { finish(); }
+
+    /**
+     * @brief Submit a task of the group
+     */
+    void run(TaskScheduler::Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++pending_;
+        }
+        scheduler_.submit([this, task = std::move(task)]() {
+            std::exception_ptr error{};
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error && !error_)
+                error_ = std::move(error);
+            if (--pending_ == 0)
+                done_.notify_all();
+        });
+    }
+
+    /**
+     * @brief Run queued tasks until every task of the group returned
+     * @throw The first exception thrown by a task of the group since the last wait()
+     */
+    void wait()
+    {
+        finish();
+        std::exception_ptr error{};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error.swap(error_);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    /**
+     * @brief Run queued tasks until every task of the group returned, keeping a task exception for wait()
+     */
+    void finish()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (pending_ != 0)
+        {
+            lock.unlock();
+            const bool ran = scheduler_.runOne();
+            lock.lock();
+            // Nothing to help with: the remaining tasks run elsewhere, their completion wakes us
+            if (!ran)
+                done_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return pending_ == 0; });
+        }
+    }
+
+    TaskScheduler &scheduler_;
+    std::mutex mutex_;              ///< Guards pending_ and error_
+    std::condition_variable done_;  ///< Signals that pending_ dropped to 0
+    std::size_t pending_;           ///< Submitted tasks that did not return yet
+    std::exception_ptr error_;      ///< First exception thrown by a task, nullptr if none
+};
+
+template <typename Body>
+void TaskScheduler::parallelFor(std::size_t count, Body &&body)
+{
+    if (count == 0)
+        return;
+
+    const auto chunks = std::min(count, 4 * (size() + 1));
+    const auto chunkSize = (count + chunks - 1) / chunks;
+    TaskGroup group(*this);
+    for (std::size_t begin = chunkSize; begin < count; begin += chunkSize)
+    {
+        const auto end = std::min(count, begin + chunkSize);
+        group.run([&body, begin, end]() {
+            for (auto i = begin; i < end; ++i)
+                body(i);
+        });
+    }
+    // Should body throw here, ~TaskGroup still waits for the other chunks before the exception leaves
+    for (std::size_t i = 0; i < chunkSize; ++i)
+        body(i);
+    group.wait();
+}
+
+}  // namespace warehouse
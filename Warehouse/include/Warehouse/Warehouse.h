@@ -2,7 +2,24 @@
 #include <PicoJson/picojson.h>
 
 #include <Interfaces/IWarehouse.hpp>
+#include <MagicEnum/magic_enum.hpp>
+#include <Serialization/BinarySnapshot.hpp>
+#include <Serialization/JsonSink.hpp>
+#include <Serialization/MappedFile.hpp>
+#include <Serialization/MappedSnapshot.hpp>
+#include <Serialization/WarehouseStateLoader.hpp>
+#include <Serialization/WriteAheadLog.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -12,24 +29,77 @@
 #include "Departments/SmallElectronicDepartment.hpp"
 #include "Departments/SpecialDepartment.hpp"
 #include "Factory/ProductFactory.hpp"
+#include "Factory/ProductRegistry.hpp"
+#include "Warehouse/BatchPacker.hpp"
+#include "Warehouse/DepartmentRouter.hpp"
+#include "Warehouse/FitIndex.hpp"
+#include "Warehouse/OrderBatch.hpp"
+#include "Warehouse/TaskScheduler.hpp"
+#include "Warehouse/WarehouseJournal.hpp"
 
 namespace warehouse
 {
+
+/**
+ * @brief How newDelivery() places products and when it spreads a delivery over the task scheduler of the warehouse
+ */
+struct DeliveryOptions
+{
+    std::size_t parallelThreshold = 4096;                 ///< Smallest delivery placed in parallel
+    PlacementPolicy placement = PlacementPolicy::firstFit;  ///< Department chosen among those with room
+    bool packDeliveries = false;                            ///< Plan every delivery as a whole with BatchPacker instead
+};
+
+/**
+ * @brief Creates an empty department of a serialized class when a state is loaded, nullptr for unknown classes
+ */
+using DepartmentFactory = std::function<warehouseInterface::IDepartmentPtr(const std::string &className, float maxOccupancy)>;
+
 class Warehouse : public warehouseInterface::IWarehouse
 {
 public:
-    Warehouse() : departments_() {}
+    Warehouse() : Warehouse(nullptr) {}
+
+    /**
+     * @brief Construct a warehouse running large deliveries, their reports and saveWarehouseState() on a scheduler
+     * @param scheduler Scheduler shared with other users, nullptr to run everything on the calling thread
+     */
+    explicit Warehouse(std::shared_ptr<TaskScheduler> scheduler) :
+            departments_(),
+            baseDepartments_(),
+            router_(),
+            journal_(),
+            deliveryOptions_(),
+            scheduler_(std::move(scheduler)),
+            reportDirty_(),
+            reportCache_(),
+            fitIndex_(),
+            fitIndexed_(false),
+            departmentFactory_()
+    {}
 
     void addDepartment(warehouseInterface::IDepartmentPtr department) override
     {
-        if (department)
+        if (!department)
+            return;
+
+        if (journal_)
         {
-            departments_.push_back(std::move(department));
+            journal_->append(wal::Record::addDepartment(department->departmentName(), department->getMaxOccupancy()));
+            journal_->commit();
         }
+        insertDepartment(std::move(department));
     }
 
     warehouseInterface::DeliveryReportJson newDelivery(std::vector<warehouseInterface::IProductPtr> products) override
     {
+        if (deliveryOptions_.packDeliveries)
+            return newPackedDelivery(products);
+        if (!fitIndexed_)
+            rebuildFitIndex();
+        if (scheduler_ && products.size() >= deliveryOptions_.parallelThreshold)
+            return newParallelDelivery(products);
+
         picojson::array report;
 
         for (auto &product : products)
@@ -40,20 +110,21 @@ public:
             picojson::object delivery;
             delivery["productName"] = picojson::value(product->name());
 
-            bool delivered = false;
-            for (const auto &department : departments_)
+            auto logged = journal_ ? wal::Record::addItem(0, productClassName(*product), product->name(), product->itemSize())
+                                   : wal::Record{};
+            const auto index = storeProduct(product);
+            if (index < departments_.size())
             {
-                if (department->addItem(std::move(product)))
+                if (journal_)
                 {
-                    delivery["status"] = picojson::value("Success");
-                    delivery["assignedDepartment"] = picojson::value(department->departmentName());
-                    delivery["errorLog"] = picojson::value("");
-                    delivered = true;
-                    break;
+                    logged.department = index;
+                    journal_->append(logged);
                 }
+                delivery["status"] = picojson::value("Success");
+                delivery["assignedDepartment"] = picojson::value(departments_[index]->departmentName());
+                delivery["errorLog"] = picojson::value("");
             }
-
-            if (!delivered)
+            else
             {
                 delivery["status"] = picojson::value("Fail");
                 delivery["assignedDepartment"] = picojson::value("None");
@@ -63,11 +134,31 @@ public:
             report.push_back(picojson::value(delivery));
         }
 
+        if (journal_)
+            journal_->commit();
+
         picojson::object result;
         result["deliveryReport"] = picojson::value(report);
         return picojson::value(result).serialize();
     }
 
+    /**
+     * @brief Choose the placement policy and which deliveries are placed in parallel, see DeliveryOptions
+     *
+     * Every policy finds its department in a FitIndex over the free space of the departments, built
+     * by the next delivery and updated whenever a department changes. Packed deliveries are planned as a
+     * whole first and ignore both the policy and the scheduler. Parallel deliveries need a scheduler
+     * given at construction. They place the products routed to
+     * departments no other product of the delivery can reach in tasks of their own. Products sharing
+     * a department are placed by one task in delivery order, so placements, report and journal are the
+     * same as those of a sequential delivery.
+     */
+    void configureDelivery(DeliveryOptions options)
+    {
+        deliveryOptions_ = options;
+        fitIndexed_ = false;
+    }
+
     warehouseInterface::Order newOrder(const warehouseInterface::OrderJson &orderJson) override
     {
         warehouseInterface::Order order{std::vector<warehouseInterface::IProductPtr>{}, orderJson};
@@ -80,134 +171,1034 @@ public:
         for (const auto &item : orderArray)
         {
             const auto &itemObj = item.get<picojson::object>();
-            std::string itemJson = picojson::value(itemObj).serialize();
+            const auto query = ProductQuery::fromJson(itemObj);
+            const auto symbols = query.symbols();
+            std::string itemJson{};
 
-            for (const auto &department : departments_)
+            for (std::size_t i = 0; i < departments_.size(); ++i)
             {
-                auto product = department->getItem(itemJson);
+                warehouseInterface::IProductPtr product{};
+                if (baseDepartments_[i])
+                {
+                    product = baseDepartments_[i]->takeItem(query, symbols);
+                }
+                else
+                {
+                    // Departments from outside this library only understand the serialized description
+                    if (itemJson.empty())
+                        itemJson = picojson::value(itemObj).serialize();
+                    product = departments_[i]->getItem(itemJson);
+                }
+
                 if (product)
                 {
+                    departmentChanged(i);
+                    if (journal_)
+                        journal_->append(wal::Record::takeItem(static_cast<std::uint32_t>(i), query.className, query.name,
+                                                               query.minSize, query.maxSize));
                     order.products.push_back(std::move(product));
                     break;
                 }
             }
         }
 
+        if (journal_)
+            journal_->commit();
         return order;
     }
 
-    warehouseInterface::OccupancyReportJson getOccupancyReport() const override
+    /**
+     * @brief Serve a wave of orders, with the same result as newOrder() called for each of them in turn
+     *
+     * Orders are parsed up front, in parallel on the scheduler if there is one, and every department
+     * is then offered the lines still open in batch order once. The wave is journaled with one commit.
+     *
+     * @param orders Serialized orders, earlier orders take items first
+     * @return One order per entry of orders, in the same order
+     * @throw The exception newOrder() throws for the first malformed order, before any item is taken
+     */
+    std::vector<warehouseInterface::Order> newOrders(const std::vector<warehouseInterface::OrderJson> &orders)
     {
-        picojson::array departmentsOccupancy;
+        OrderBatch batch(orders, scheduler_.get());
+        for (std::size_t i = 0; i < departments_.size() && !batch.done(); ++i)
+        {
+            auto *base = baseDepartments_[i];
+            auto &department = *departments_[i];
+            batch.visitDepartment(static_cast<std::uint32_t>(i), [base, &department](OrderBatch::Line &line) {
+                if (base)
+                    return base->takeItem(line.query, line.symbols);
+                return department.getItem(line.serializedDescription());
+            });
+            departmentChanged(i);
+        }
 
-        for (const auto &department : departments_)
+        if (journal_)
         {
-            picojson::object dept;
-            dept["departmentName"] = picojson::value(department->departmentName());
-            dept["maxOccupancy"] = picojson::value(department->getMaxOccupancy());
-            dept["occupancy"] = picojson::value(department->getOccupancy());
-            departmentsOccupancy.push_back(picojson::value(dept));
+            for (const auto &line : batch.lines())
+            {
+                if (line.department != OrderBatch::noDepartment)
+                {
+                    const auto &query = line.query;
+                    journal_->append(wal::Record::takeItem(line.department, query.className, query.name, query.minSize, query.maxSize));
+                }
+            }
+            journal_->commit();
         }
+        return batch.release();
+    }
 
-        picojson::object result;
-        result["departmentsOccupancy"] = picojson::value(departmentsOccupancy);
-        return picojson::value(result).serialize();
+    warehouseInterface::OccupancyReportJson getOccupancyReport() const override { return *occupancyReport(); }
+
+    /**
+     * @brief Get the occupancy report without copying it
+     *
+     * The report is cached: only the entries of departments changed through the warehouse since the
+     * last call are rendered again, an unchanged warehouse returns the same buffer without allocating.
+     * Departments changed behind the warehouse's back are not noticed.
+     *
+     * @return Serialized report, the same bytes as getOccupancyReport()
+     */
+    std::shared_ptr<const std::string> occupancyReport() const
+    {
+        std::lock_guard<std::mutex> lock(reportCache_.mutex);
+        auto &cache = reportCache_;
+        bool changed = !cache.report;
+        cache.entries.resize(departments_.size());
+        for (std::size_t i = 0; i < departments_.size(); ++i)
+        {
+            if (!reportDirty_[i])
+                continue;
+            reportDirty_[i] = false;
+            changed = true;
+
+            // Keys in the order picojson::object keeps them
+            const auto &department = *departments_[i];
+            JsonSink entry;
+            entry.beginObject();
+            entry.key("departmentName");
+            entry.value(department.departmentName());
+            entry.key("maxOccupancy");
+            entry.value(static_cast<double>(department.getMaxOccupancy()));
+            entry.key("occupancy");
+            entry.value(static_cast<double>(department.getOccupancy()));
+            entry.endObject();
+            cache.entries[i] = entry.release();
+        }
+        if (!changed)
+            return cache.report;
+
+        JsonSink sink;
+        sink.beginObject();
+        sink.key("departmentsOccupancy");
+        sink.beginArray();
+        for (const auto &entry : cache.entries)
+            sink.rawValue(entry);
+        sink.endArray();
+        sink.endObject();
+        cache.report = std::make_shared<const std::string>(sink.release());
+        return cache.report;
     }
 
+    /**
+     * @brief Serialize the warehouse, departments are serialized in parallel on the scheduler if there is one
+     */
     warehouseInterface::WarehouseStateJson saveWarehouseState() const override
     {
-        picojson::array departments;
-
-        for (const auto &department : departments_)
+        JsonSink sink;
+        if (!scheduler_ || departments_.size() < 2)
         {
-            picojson::value val;
-            picojson::parse(val, department->serialize());
-            departments.push_back(val);
+            writeWarehouseState(sink);
+            return sink.release();
         }
 
-        picojson::object result;
-        result["warehouseState"] = picojson::value(departments);
-        return picojson::value(result).serialize();
+        std::vector<std::string> departments(departments_.size());
+        scheduler_->parallelFor(departments.size(), [this, &departments](std::size_t i) {
+            JsonSink department;
+            writeDepartmentJson(department, *departments_[i], baseDepartments_[i]);
+            departments[i] = department.release();
+        });
+
+        sink.beginObject();
+        sink.key("warehouseState");
+        sink.beginArray();
+        for (const auto &department : departments)
+            sink.rawValue(department);
+        sink.endArray();
+        sink.endObject();
+        return sink.release();
+    }
+
+    /**
+     * @brief Stream the warehouse state (the same bytes as saveWarehouseState()) without building it in memory
+     * @param out Destination stream
+     */
+    void writeWarehouseState(std::ostream &out) const
+    {
+        JsonSink sink(out);
+        writeWarehouseState(sink);
+        sink.flush();
     }
 
     bool loadWarehouseState(const warehouseInterface::WarehouseStateJson &stateJson) override
     {
-        picojson::value val;
-        picojson::parse(val, stateJson);
+        return readWarehouseState(stateJson.begin(), stateJson.end());
+    }
+
+    /**
+     * @brief Load the warehouse state from a character range without building a JSON tree
+     *
+     * Departments and products are created while the input is parsed. Products of unknown
+     * classes are skipped, unknown departments and missing fields make the load fail.
+     * @param first Begin of the serialized state
+     * @param last End of the serialized state
+     * @return true if state is valid (contains all required fields), false otherwise
+     */
+    template <typename Iter>
+    bool readWarehouseState(const Iter &first, const Iter &last)
+    {
+        auto loader = makeStateLoader();
+        return journaled(loader.load(first, last));
+    }
+
+    /**
+     * @brief Load the warehouse state from a stream, see readWarehouseState(first, last)
+     * @param in Source stream
+     * @return true if state is valid (contains all required fields), false otherwise
+     */
+    bool readWarehouseState(std::istream &in)
+    {
+        auto loader = makeStateLoader();
+        return journaled(loader.load(in));
+    }
 
-        if (!val.is<picojson::object>())
+    /**
+     * @brief Load the warehouse state from a memory mapped file, see readWarehouseState(first, last)
+     * @param path State file written by writeWarehouseState()
+     * @return true if the file exists and the state is valid, false otherwise
+     */
+    bool readWarehouseStateFile(const std::string &path)
+    {
+        MappedFile file;
+        if (!file.open(path))
             return false;
-        const auto &obj = val.get<picojson::object>();
+        return readWarehouseState(file.begin(), file.end());
+    }
 
-        if (!obj.count("warehouseState"))
+    /**
+     * @brief Save the warehouse state as a binary snapshot
+     *
+     * Holds the same information as saveWarehouseState(), with names interned in a string table
+     * and sizes, flags and classes stored in packed columns. See BinarySnapshot.hpp for the layout.
+     * @return Snapshot bytes
+     */
+    std::string saveWarehouseStateBinary() const
+    {
+        SnapshotWriter writer;
+        for (std::size_t i = 0; i < departments_.size(); ++i)
+        {
+            writer.beginDepartment(departments_[i]->departmentName(), departments_[i]->getMaxOccupancy());
+            if (!baseDepartments_[i])
+            {
+                for (const auto &item : departments_[i]->serializedItems())
+                    writeSnapshotItem(writer, item);
+                continue;
+            }
+
+            const auto &mapped = baseDepartments_[i]->mappedItems();
+            mapped.forEach([&writer, &mapped](MappedItems::Position position) {
+                writer.addItem(writer.productClass(mapped.className(position)),
+                               mapped.name(position),
+                               mapped.itemSize(position),
+                               static_cast<std::uint8_t>(mapped.itemFlags(position)));
+            });
+
+            // Products mostly arrive in runs of one class, the class id is looked up once per run
+            Symbol runSymbol = noSymbol;
+            std::uint16_t runClass = 0;
+            const auto &interner = StringInterner::global();
+            baseDepartments_[i]->forEachItem([&](const ItemStore::Item &item) {
+                if (item.classSymbol == noSymbol)
+                {
+                    picojson::value val;
+                    picojson::parse(val, item.product.serialize());
+                    writeSnapshotItem(writer, val);
+                    return;
+                }
+                if (item.classSymbol != runSymbol)
+                {
+                    runSymbol = item.classSymbol;
+                    runClass = writer.productClass(interner.view(item.classSymbol));
+                }
+                writer.addItem(runClass, interner.view(item.nameSymbol), item.size, static_cast<std::uint8_t>(item.flags));
+            });
+        }
+        return writer.finish();
+    }
+
+    /**
+     * @brief Load the warehouse state from a binary snapshot
+     *
+     * Follows loadWarehouseState(): products of unknown classes are skipped, unknown departments
+     * make the load fail. Corrupted snapshots and unknown departments are rejected before the
+     * current state is dropped.
+     * @param data First snapshot byte
+     * @param size Snapshot length in bytes
+     * @return true if the snapshot is valid, false otherwise
+     */
+    bool loadWarehouseStateBinary(const char *data, std::size_t size)
+    {
+        SnapshotReader reader;
+        if (!reader.open(data, size))
             return false;
-        const auto &departments = obj.at("warehouseState").get<picojson::array>();
 
-        departments_.clear();
-        for (const auto &dept : departments)
+        std::vector<const ProductRegistry::Creator *> creators{};
+        for (std::size_t i = 0; i < reader.classCount(); ++i)
+            creators.push_back(ProductRegistry::global().find(reader.productClass(static_cast<std::uint16_t>(i))));
+
+        auto departments = makeDepartments(reader);
+        if (departments.size() != reader.departmentCount())
+            return false;
+
+        clearDepartments();
+        std::string name{};
+        for (std::size_t i = 0; i < reader.departmentCount(); ++i)
         {
-            if (!dept.is<picojson::object>())
-                return false;
-            const auto &deptObj = dept.get<picojson::object>();
+            const auto record = reader.department(i);
+            insertDepartment(std::move(departments[i]));
+            for (std::size_t item = record.firstItem; item < record.firstItem + record.itemCount; ++item)
+            {
+                name.assign(reader.string(reader.itemName(item)));
+                loadItem(creators[reader.itemClass(item)], name, reader.itemSize(item));
+            }
+        }
+        return journaled(true);
+    }
+
+    bool loadWarehouseStateBinary(const std::string &snapshot)
+    {
+        return loadWarehouseStateBinary(snapshot.data(), snapshot.size());
+    }
+
+    /**
+     * @brief Serve the warehouse state straight from a memory mapped binary snapshot file
+     *
+     * Departments are created right away, their items stay in the mapped file: occupancy reports,
+     * serialization and order lookups read the mapping, and products are materialized only when an
+     * order takes them. Without full validation opening costs the same regardless of the item
+     * count, and a corrupted item degrades to an empty name or an unknown class instead of failing
+     * the whole load.
+     *
+     * @param path Snapshot file written from saveWarehouseStateBinary()
+     * @param validate Verify the checksum and every item before serving the snapshot
+     * @return true if the snapshot was opened, false if it is invalid or holds unknown classes, the
+     *         current state is kept in that case
+     */
+    bool openWarehouseStateSnapshot(const std::string &path, bool validate = false)
+    {
+        auto snapshot = std::make_shared<MappedSnapshot>(
+                [](const std::string &className, const std::string &name, float size) {
+                    return ProductRegistry::global().create(className, name, size);
+                });
+        if (!snapshot->open(path, validate ? SnapshotReader::Validation::full : SnapshotReader::Validation::lazy))
+            return false;
 
-            if (!deptObj.count("class"))
+        // A regular load would skip products of unknown classes, a mapping cannot hide them
+        const auto &reader = snapshot->reader();
+        for (std::size_t i = 0; i < reader.classCount(); ++i)
+        {
+            if (!ProductRegistry::global().find(reader.productClass(static_cast<std::uint16_t>(i))))
                 return false;
-            const std::string &className = deptObj.at("class").get<std::string>();
+        }
 
-            if (!deptObj.count("maxOccupancy"))
+        auto departments = makeDepartments(reader);
+        if (departments.size() != reader.departmentCount())
+            return false;
+
+        clearDepartments();
+        for (std::size_t i = 0; i < departments.size(); ++i)
+        {
+            insertDepartment(std::move(departments[i]));
+            baseDepartments_.back()->attachMappedItems(MappedItems(snapshot, i));
+        }
+        return journaled(true);
+    }
+
+    /**
+     * @brief Make the warehouse durable through a snapshot plus operation log journal
+     *
+     * An existing journal in the directory is recovered: its newest snapshot is loaded and the logs
+     * written after it are replayed, replacing the current state. An empty directory starts a
+     * journal from the current state. From then on every department, delivery and order is logged
+     * with one group commit per call, and full loads start a new journal generation. A load whose
+     * generation cannot be written returns false and leaves the journal unhealthy.
+     * Departments from outside this library cannot be recovered.
+     *
+     * @param directory Journal directory, created if needed
+     * @param options Sync policy and automatic checkpoint size
+     * @return true if the journal was recovered and opened, false otherwise
+     */
+    bool openJournal(const std::string &directory, JournalOptions options = JournalOptions())
+    {
+        closeJournal();
+
+        std::uint64_t generation = 1;
+        if (const auto latest = WarehouseJournal::latestSnapshot(directory))
+        {
+            if (!recoverJournal(directory, *latest, generation))
                 return false;
-            float maxOccupancy = static_cast<float>(deptObj.at("maxOccupancy").get<double>());
+            ++generation;
+        }
 
-            // Create department of required type
-            if (className == "ColdRoomDepartment")
-            {
-                addDepartment(std::make_unique<ColdRoomDepartment>(maxOccupancy));
-            }
-            else if (className == "SmallElectronicDepartment")
+        journal_ = std::make_unique<WarehouseJournal>(directory, options, &Warehouse::foldJournal);
+        if (!journal_->start(generation, saveWarehouseStateBinary()))
+        {
+            journal_.reset();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Write pending records, wait for the background compaction and stop logging
+     */
+    void closeJournal() { journal_.reset(); }
+
+    /**
+     * @brief Start a new log generation and fold the previous ones into a snapshot in the background
+     * @return true if the journal is open and the new log could be created, false otherwise
+     */
+    bool checkpointJournal() { return journal_ && journal_->checkpoint(); }
+
+    /**
+     * @brief Block until the background compaction started by the last checkpoint finished
+     */
+    void waitForJournalCompaction()
+    {
+        if (journal_)
+            journal_->waitForCompaction();
+    }
+
+    /**
+     * @brief Check that the journal is open and no write or sync failed
+     */
+    bool isJournalHealthy() const { return journal_ && journal_->isHealthy(); }
+
+    /**
+     * @brief Choose how loads create departments
+     * @param factory Department factory, nullptr for makeDepartment()
+     */
+    void setDepartmentFactory(DepartmentFactory factory) { departmentFactory_ = std::move(factory); }
+
+    /**
+     * @brief Create an empty department of a serialized class, the default department factory
+     * @return The department, nullptr if the class is unknown
+     */
+    static warehouseInterface::IDepartmentPtr makeDepartment(const std::string &className, float maxOccupancy)
+    {
+        if (className == "ColdRoomDepartment")
+            return std::make_unique<ColdRoomDepartment>(maxOccupancy);
+        if (className == "SmallElectronicDepartment")
+            return std::make_unique<SmallElectronicDepartment>(maxOccupancy);
+        if (className == "OverSizeElectronicDepartment")
+            return std::make_unique<OverSizeElectronicDepartment>(maxOccupancy);
+        if (className == "HazardousDepartment")
+            return std::make_unique<HazardousDepartment>(maxOccupancy);
+        if (className == "SpecialDepartment")
+            return std::make_unique<SpecialDepartment>(maxOccupancy);
+        return nullptr;
+    }
+
+    /**
+     * @brief Hand over every department in warehouse order, leaving the warehouse empty
+     *
+     * The journal does not record the handover.
+     */
+    std::vector<warehouseInterface::IDepartmentPtr> releaseDepartments()
+    {
+        std::vector<warehouseInterface::IDepartmentPtr> departments{};
+        departments.swap(departments_);
+        clearDepartments();
+        return departments;
+    }
+
+    /**
+     * @brief Write one department of the "warehouseState" array
+     * @param sink Destination sink
+     * @param department Department to write
+     * @param base The department if it derives from BaseDepartment, nullptr otherwise
+     */
+    static void writeDepartmentJson(JsonSink &sink, const warehouseInterface::IDepartment &department, const BaseDepartment *base)
+    {
+        if (base)
+        {
+            base->writeJson(sink);
+            return;
+        }
+
+        // Normalize foreign serializations, as they are not guaranteed to be in picojson form
+        picojson::value val;
+        picojson::parse(val, department.serialize());
+        sink.rawValue(val.serialize());
+    }
+
+private:
+    /**
+     * @brief Add a product known only by its serialized form to a snapshot
+     */
+    static void writeSnapshotItem(SnapshotWriter &writer, const picojson::value &item)
+    {
+        if (!item.is<picojson::object>())
+            return;
+        const auto &obj = item.get<picojson::object>();
+        const auto className = obj.find("class");
+        const auto name = obj.find("name");
+        const auto size = obj.find("size");
+        if (className == obj.end() || name == obj.end() || size == obj.end() || !className->second.is<std::string>() ||
+            !name->second.is<std::string>() || !size->second.is<double>())
+            return;
+
+        int flags = 0;
+        const auto flagNames = obj.find("flags");
+        if (flagNames != obj.end() && flagNames->second.is<picojson::array>())
+        {
+            for (const auto &flagName : flagNames->second.get<picojson::array>())
             {
-                addDepartment(std::make_unique<SmallElectronicDepartment>(maxOccupancy));
+                if (!flagName.is<std::string>())
+                    continue;
+                if (const auto flag = magic_enum::enum_cast<warehouseInterface::ProductLabelFlags>(flagName.get<std::string>()))
+                    flags |= static_cast<int>(*flag);
             }
-            else if (className == "OverSizeElectronicDepartment")
+        }
+
+        writer.addItem(writer.productClass(className->second.get<std::string>()),
+                       name->second.get<std::string>(),
+                       static_cast<float>(size->second.get<double>()),
+                       static_cast<std::uint8_t>(flags));
+    }
+
+    WarehouseStateLoader makeStateLoader()
+    {
+        return WarehouseStateLoader(
+                [this]() { clearDepartments(); },
+                [this](const std::string &className, float maxOccupancy) {
+                    return createDepartment(className, maxOccupancy);
+                },
+                [this](const std::string &className, const std::string &name, float size) {
+                    loadItem(className, name, size);
+                    return true;
+                });
+    }
+
+    void clearDepartments()
+    {
+        departments_.clear();
+        baseDepartments_.clear();
+        router_.clear();
+        reportDirty_.clear();
+        reportCache_.report.reset();
+        fitIndexed_ = false;
+    }
+
+    /**
+     * @brief Store a loaded product in the last created department, unknown product classes are skipped
+     */
+    void loadItem(const std::string &className, const std::string &name, float size)
+    {
+        loadItem(ProductRegistry::global().find(className), name, size);
+    }
+
+    void loadItem(const ProductRegistry::Creator *creator, const std::string &name, float size)
+    {
+        if (creator)
+            departments_.back()->addItem((*creator)(name, size));
+    }
+
+    void insertDepartment(warehouseInterface::IDepartmentPtr department)
+    {
+        router_.addDepartment(department.get());
+        baseDepartments_.push_back(dynamic_cast<BaseDepartment *>(department.get()));
+        departments_.push_back(std::move(department));
+        reportDirty_.push_back(true);
+        if (fitIndexed_)
+            fitIndex_.addDepartment(departments_.back()->getSupportedFlags(), freeOccupancyUnits(departments_.size() - 1));
+    }
+
+    std::uint32_t departmentIndex(const warehouseInterface::IDepartment *department) const
+    {
+        std::uint32_t index = 0;
+        while (index < departments_.size() && departments_[index].get() != department)
+            ++index;
+        return index;
+    }
+
+    static std::string productClassName(const warehouseInterface::IProduct &product)
+    {
+        if (const auto *base = dynamic_cast<const BaseProduct *>(&product))
+            return std::string(base->classNameView());
+
+        picojson::value val;
+        picojson::parse(val, product.serialize());
+        if (val.is<picojson::object>())
+        {
+            const auto &obj = val.get<picojson::object>();
+            const auto className = obj.find("class");
+            if (className != obj.end() && className->second.is<std::string>())
+                return className->second.get<std::string>();
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief Start a new journal generation after the state was replaced by a load
+     * @param loaded Result of the load
+     * @return loaded, false if the new generation could not be written, isJournalHealthy() then reports the failure
+     */
+    bool journaled(bool loaded)
+    {
+        if (journal_ && !journal_->start(journal_->generation() + 1, saveWarehouseStateBinary()))
+            return false;
+        return loaded;
+    }
+
+    /**
+     * @brief Load the newest journal snapshot and replay the logs written after it
+     * @param lastGeneration Set to the newest generation found
+     */
+    bool recoverJournal(const std::string &directory, std::uint64_t snapshotGeneration, std::uint64_t &lastGeneration)
+    {
+        MappedFile file;
+        if (!file.open(WarehouseJournal::snapshotPath(directory, snapshotGeneration)) ||
+            !loadWarehouseStateBinary(file.data(), file.size()))
+            return false;
+
+        lastGeneration = snapshotGeneration;
+        for (auto generation = snapshotGeneration;; ++generation)
+        {
+            const auto path = WarehouseJournal::logPath(directory, generation);
+            std::error_code error;
+            if (!std::filesystem::exists(path, error))
+                break;
+            if (!replayLog(path))
+                return false;
+            lastGeneration = generation;
+        }
+        return true;
+    }
+
+    bool replayLog(const std::string &path)
+    {
+        return WriteAheadLog::replay(path, [this](const wal::Record &record) { return applyRecord(record); });
+    }
+
+    /**
+     * @brief Repeat a logged operation, departments are addressed by index so placement is reproduced exactly
+     */
+    bool applyRecord(const wal::Record &record)
+    {
+        if (record.type == wal::RecordType::department)
+            return record.className && createDepartment(*record.className, record.size);
+        if (record.department >= departments_.size() || !baseDepartments_[record.department])
+            return false;
+
+        if (record.type == wal::RecordType::addItem)
+        {
+            if (!record.className || !record.name)
+                return false;
+            auto product = ProductFactory().createProduct(*record.className, *record.name, record.size);
+            if (product)
+                departments_[record.department]->addItem(std::move(product));
+        }
+        else
+        {
+            const ProductQuery query{record.className, record.name, record.minSize, record.maxSize};
+            baseDepartments_[record.department]->takeItem(query);
+        }
+        departmentChanged(record.department);
+        return true;
+    }
+
+    /**
+     * @brief Journal compaction, runs on the background thread and only touches files
+     */
+    static bool foldJournal(const std::string &directory, std::uint64_t fromGeneration, std::uint64_t toGeneration)
+    {
+        Warehouse scratch{};
+        MappedFile file;
+        if (!file.open(WarehouseJournal::snapshotPath(directory, fromGeneration)) ||
+            !scratch.loadWarehouseStateBinary(file.data(), file.size()))
+            return false;
+        file.close();
+
+        for (auto generation = fromGeneration; generation < toGeneration; ++generation)
+        {
+            if (!scratch.replayLog(WarehouseJournal::logPath(directory, generation)))
+                return false;
+        }
+        if (!WarehouseJournal::writeFile(WarehouseJournal::snapshotPath(directory, toGeneration), scratch.saveWarehouseStateBinary()))
+            return false;
+        WarehouseJournal::removeGenerationsBefore(directory, toGeneration);
+        return true;
+    }
+
+    bool createDepartment(const std::string &className, float maxOccupancy)
+    {
+        auto department = newDepartment(className, maxOccupancy);
+        if (!department)
+            return false;
+        insertDepartment(std::move(department));
+        return true;
+    }
+
+    warehouseInterface::IDepartmentPtr newDepartment(const std::string &className, float maxOccupancy) const
+    {
+        return departmentFactory_ ? departmentFactory_(className, maxOccupancy) : makeDepartment(className, maxOccupancy);
+    }
+
+    /**
+     * @brief Create the empty departments of a binary snapshot without touching the current state
+     * @return One department per snapshot department, fewer if a class is unknown
+     */
+    std::vector<warehouseInterface::IDepartmentPtr> makeDepartments(const SnapshotReader &reader) const
+    {
+        std::vector<warehouseInterface::IDepartmentPtr> departments{};
+        for (std::size_t i = 0; i < reader.departmentCount(); ++i)
+        {
+            const auto record = reader.department(i);
+            auto department = newDepartment(std::string(reader.string(record.classId)), record.maxOccupancy);
+            if (!department)
+                break;
+            departments.push_back(std::move(department));
+        }
+        return departments;
+    }
+
+    /**
+     * @brief Place a delivery on scheduler_, one task per group of products sharing departments
+     *
+     * Flags masks whose candidate departments overlap are merged with a union-find over the
+     * departments, every group then runs the sequential first-fit loop over its products in delivery
+     * order. The report is written afterwards in delivery order.
+     */
+    warehouseInterface::DeliveryReportJson newParallelDelivery(std::vector<warehouseInterface::IProductPtr> &products)
+    {
+        constexpr std::size_t noGroup = static_cast<std::size_t>(-1);
+        const auto departmentCount = departments_.size();
+
+        // Merge the departments reachable from every mask of the delivery
+        std::vector<std::size_t> parent(departmentCount);
+        std::iota(parent.begin(), parent.end(), std::size_t{0});
+        const auto root = [&parent](std::size_t department) {
+            while (parent[department] != department)
+                department = parent[department] = parent[parent[department]];
+            return department;
+        };
+        std::array<bool, DepartmentRouter::bucketsCount> seen{};
+        for (const auto &product : products)
+        {
+            const auto mask = product ? static_cast<std::size_t>(product->itemFlags()) : DepartmentRouter::bucketsCount;
+            if (mask >= DepartmentRouter::bucketsCount || seen[mask])
+                continue;
+            seen[mask] = true;
+            const auto &candidates = router_.candidates(product->itemFlags());
+            for (std::size_t i = 1; i < candidates.size(); ++i)
+                parent[root(departmentIndex(candidates[i]))] = root(departmentIndex(candidates[0]));
+        }
+
+        std::array<std::size_t, DepartmentRouter::bucketsCount> maskGroup{};
+        std::vector<std::size_t> rootGroup(departmentCount, noGroup);
+        std::vector<std::vector<std::size_t>> groups{};
+        for (std::size_t mask = 0; mask < DepartmentRouter::bucketsCount; ++mask)
+        {
+            maskGroup[mask] = noGroup;
+            const auto &candidates = router_.candidates(static_cast<warehouseInterface::ProductLabelFlags>(mask));
+            if (!seen[mask] || candidates.empty())
+                continue;
+            auto &group = rootGroup[root(departmentIndex(candidates[0]))];
+            if (group == noGroup)
             {
-                addDepartment(std::make_unique<OverSizeElectronicDepartment>(maxOccupancy));
+                group = groups.size();
+                groups.emplace_back();
             }
-            else if (className == "HazardousDepartment")
+            maskGroup[mask] = group;
+        }
+
+        // Products no department can take fail without being placed
+        std::vector<DeliveryPlacement> placements(products.size());
+        for (std::size_t i = 0; i < products.size(); ++i)
+        {
+            if (!products[i])
+                continue;
+            const auto mask = static_cast<std::size_t>(products[i]->itemFlags());
+            const auto group = mask < DepartmentRouter::bucketsCount ? maskGroup[mask] : noGroup;
+            if (group != noGroup)
+                groups[group].push_back(i);
+            else
+                placements[i] = placeProduct(products[i]);
+        }
+
+        // Largest groups first, the smaller ones fill in around them
+        std::sort(groups.begin(), groups.end(), [](const auto &a, const auto &b) { return a.size() > b.size(); });
+        scheduler_->parallelFor(groups.size(), [this, &groups, &products, &placements](std::size_t group) {
+            for (const auto i : groups[group])
+                placements[i] = placeProduct(products[i]);
+        });
+
+        std::vector<std::string> departmentNames{};
+        for (const auto &department : departments_)
+            departmentNames.push_back(department->departmentName());
+
+        if (journal_)
+        {
+            for (auto &placement : placements)
             {
-                addDepartment(std::make_unique<HazardousDepartment>(maxOccupancy));
+                if (!placement.listed || placement.department >= departmentCount)
+                    continue;
+                placement.logged.department = placement.department;
+                journal_->append(placement.logged);
             }
-            else if (className == "SpecialDepartment")
+            journal_->commit();
+        }
+
+        // Chunks of the report are written in parallel and joined in delivery order
+        constexpr std::size_t reportChunk = 4096;
+        std::vector<std::string> chunks((placements.size() + reportChunk - 1) / reportChunk);
+        scheduler_->parallelFor(chunks.size(), [&chunks, &placements, &departmentNames, departmentCount](std::size_t chunk) {
+            JsonSink part;
+            part.beginArray();
+            const auto end = std::min(placements.size(), (chunk + 1) * reportChunk);
+            for (auto i = chunk * reportChunk; i < end; ++i)
             {
-                addDepartment(std::make_unique<SpecialDepartment>(maxOccupancy));
+                const auto &placement = placements[i];
+                if (placement.listed)
+                    writeDeliveryEntry(part, placement.name, placement.department < departmentCount ? &departmentNames[placement.department] : nullptr);
             }
-            else
+            part.endArray();
+            chunks[chunk] = part.release();
+        });
+
+        JsonSink sink;
+        sink.beginObject();
+        sink.key("deliveryReport");
+        sink.beginArray();
+        for (const auto &chunk : chunks)
+            sink.rawElements(chunk);
+        sink.endArray();
+        sink.endObject();
+        return sink.release();
+    }
+
+    /**
+     * @brief Place a delivery as planned by BatchPacker, see DeliveryOptions::packDeliveries
+     *
+     * The plan only chooses departments among the router candidates of each product. Products are
+     * then stored, journaled and reported in delivery order, so the report has the layout of a
+     * sequential delivery and departments keep their items in arrival order.
+     */
+    warehouseInterface::DeliveryReportJson newPackedDelivery(std::vector<warehouseInterface::IProductPtr> &products)
+    {
+        std::vector<BatchPacker::Bin> bins{};
+        bins.reserve(departments_.size());
+        for (std::size_t i = 0; i < departments_.size(); ++i)
+            bins.push_back(BatchPacker::Bin{freeOccupancyUnits(i), departments_[i]->getMaxItemSize()});
+
+        // Candidate indices per flags mask, in the router order
+        static const std::vector<std::uint32_t> noCandidates{};
+        std::vector<std::vector<std::uint32_t>> maskCandidates(DepartmentRouter::bucketsCount);
+        std::array<bool, DepartmentRouter::bucketsCount> routed{};
+        std::vector<BatchPacker::Item> items{};
+        std::vector<std::size_t> itemProducts{};
+        for (std::size_t i = 0; i < products.size(); ++i)
+        {
+            if (!products[i])
+                continue;
+            const auto flags = products[i]->itemFlags();
+            const auto mask = static_cast<std::size_t>(flags);
+            const std::vector<std::uint32_t> *candidates = &noCandidates;
+            if (mask < DepartmentRouter::bucketsCount)
             {
-                return false;
+                if (!routed[mask])
+                {
+                    for (const auto *department : router_.candidates(flags))
+                        maskCandidates[mask].push_back(departmentIndex(department));
+                    routed[mask] = true;
+                }
+                candidates = &maskCandidates[mask];
             }
+            const float size = products[i]->itemSize();
+            items.push_back(BatchPacker::Item{toOccupancyUnits(size), size, candidates});
+            itemProducts.push_back(i);
+        }
+        const auto assigned = BatchPacker(std::move(bins)).pack(items);
 
-            // Load products into department
-            if (deptObj.count("items"))
+        JsonSink sink;
+        sink.beginObject();
+        sink.key("deliveryReport");
+        sink.beginArray();
+        for (std::size_t i = 0; i < items.size(); ++i)
+        {
+            auto &product = products[itemProducts[i]];
+            const auto name = product->name();
+            auto index = assigned[i];
+            std::string departmentName{};
+            if (index != BatchPacker::noDepartment)
             {
-                const auto &items = deptObj.at("items").get<picojson::array>();
-                for (const auto &item : items)
+                auto logged = journal_ ? wal::Record::addItem(index, productClassName(*product), name, items[i].size) : wal::Record{};
+                if (DepartmentRouter::hasRoomFor(*departments_[index], items[i].size) && departments_[index]->addItem(std::move(product)))
                 {
-                    std::string itemJson = picojson::value(item).serialize();
-                    auto product = ProductFactory().createProduct(
-                            item.get<picojson::object>().at("class").get<std::string>(),
-                            item.get<picojson::object>().at("name").get<std::string>(),
-                            static_cast<float>(item.get<picojson::object>().at("size").get<double>()));
-                    if (product)
-                    {
-                        departments_.back()->addItem(std::move(product));
-                    }
+                    departmentChanged(index);
+                    departmentName = departments_[index]->departmentName();
+                    if (journal_)
+                        journal_->append(logged);
+                }
+                else
+                {
+                    index = BatchPacker::noDepartment;
                 }
             }
+            writeDeliveryEntry(sink, name, index != BatchPacker::noDepartment ? &departmentName : nullptr);
         }
+        sink.endArray();
+        sink.endObject();
 
-        return true;
+        if (journal_)
+            journal_->commit();
+        return sink.release();
+    }
+
+    /**
+     * @brief Write one entry of a delivery report
+     *
+     * The keys are written in the order picojson::object keeps them, so the entry matches the one
+     * newDelivery() builds with picojson byte for byte.
+     * @param department Name of the storing department, nullptr if the product was not stored
+     */
+    static void writeDeliveryEntry(JsonSink &sink, const std::string &productName, const std::string *department)
+    {
+        sink.beginObject();
+        sink.key("assignedDepartment");
+        sink.value(department ? *department : std::string("None"));
+        sink.key("errorLog");
+        sink.value(department ? "" : "Warehouse cannot store this product. Lack of space in departments.");
+        sink.key("productName");
+        sink.value(productName);
+        sink.key("status");
+        sink.value(department ? "Success" : "Fail");
+        sink.endObject();
+    }
+
+    /**
+     * @brief Outcome of placing one product of a parallel delivery
+     */
+    struct DeliveryPlacement
+    {
+        bool listed = false;                   ///< The product was not nullptr, it has a report entry
+        std::string name{};                    ///< Product name
+        std::uint32_t department = static_cast<std::uint32_t>(-1);  ///< Index of the storing department, out of range on failure
+        wal::Record logged{};                  ///< Journal record of the product, filled only for journaled warehouses
+    };
+
+    /**
+     * @brief Place one product of a parallel delivery as newDelivery() does
+     */
+    DeliveryPlacement placeProduct(warehouseInterface::IProductPtr &product)
+    {
+        DeliveryPlacement placement{};
+        placement.listed = true;
+        placement.name = product->name();
+        if (journal_)
+            placement.logged = wal::Record::addItem(0, productClassName(*product), placement.name, product->itemSize());
+        placement.department = storeProduct(product);
+        return placement;
+    }
+
+    /**
+     * @brief Store a product in the department chosen by the placement policy
+     *
+     * Requires the fit index to be built. The index holds the exact free space of library departments,
+     * candidates are confirmed with DepartmentRouter::hasRoomFor before the product is handed over.
+     *
+     * @param product Product to store, moved from once a department was asked to store it
+     * @return Index of the storing department, out of range if no department stored the product
+     */
+    std::uint32_t storeProduct(warehouseInterface::IProductPtr &product)
+    {
+        const float size = product->itemSize();
+        const auto index = fitIndex_.select(product->itemFlags(), toOccupancyUnits(size), [this, size](std::uint32_t department) {
+            return DepartmentRouter::hasRoomFor(*departments_[department], size);
+        });
+        if (index == FitIndex::noDepartment || !departments_[index]->addItem(std::move(product)))
+            return FitIndex::noDepartment;
+        departmentChanged(index);
+        return index;
+    }
+
+    /**
+     * @brief Record that the items of a department changed, for the occupancy report and the fit index
+     *
+     * Departments of different parallel delivery groups may be recorded concurrently.
+     */
+    void departmentChanged(std::size_t index)
+    {
+        reportDirty_[index] = true;
+        if (fitIndexed_)
+            fitIndex_.update(static_cast<std::uint32_t>(index), freeOccupancyUnits(index));
+    }
+
+    /**
+     * @brief Index the free space of every department for the configured placement policy
+     */
+    void rebuildFitIndex()
+    {
+        fitIndex_.reset(deliveryOptions_.placement);
+        for (std::size_t i = 0; i < departments_.size(); ++i)
+            fitIndex_.addDepartment(departments_[i]->getSupportedFlags(), freeOccupancyUnits(i));
+        fitIndexed_ = true;
+    }
+
+    /**
+     * @brief Get the space left in a department, exact for library departments
+     */
+    OccupancyUnits freeOccupancyUnits(std::size_t index) const
+    {
+        if (baseDepartments_[index])
+            return baseDepartments_[index]->freeOccupancyUnits();
+        return toOccupancyUnits(departments_[index]->getMaxOccupancy()) - toOccupancyUnits(departments_[index]->getOccupancy());
+    }
+
+    void writeWarehouseState(JsonSink &sink) const
+    {
+        sink.beginObject();
+        sink.key("warehouseState");
+        sink.beginArray();
+        for (std::size_t i = 0; i < departments_.size(); ++i)
+            writeDepartmentJson(sink, *departments_[i], baseDepartments_[i]);
+        sink.endArray();
+        sink.endObject();
     }
 
-private:
     std::vector<warehouseInterface::IDepartmentPtr> departments_;
+    std::vector<BaseDepartment *> baseDepartments_;  ///< departments_ entries with the typed lookup, nullptr otherwise
+    DepartmentRouter router_;  ///< Delivery candidates per product flags mask
+    std::unique_ptr<WarehouseJournal> journal_;  ///< Operation log, nullptr while the warehouse is not journaled
+    DeliveryOptions deliveryOptions_;            ///< Placement policy and parallel delivery settings
+    std::shared_ptr<TaskScheduler> scheduler_;   ///< Runs the parallel operations, nullptr while everything is sequential
+
+    /**
+     * @brief Rendered occupancy report, see occupancyReport()
+     */
+    struct OccupancyReportCache
+    {
+        std::mutex mutex{};                           ///< Serializes concurrent readers of the report
+        std::vector<std::string> entries{};           ///< Rendered entry per department
+        std::shared_ptr<const std::string> report{};  ///< Rendered report, nullptr once the department list changed
+    };
+
+    /// Per department: changed since its report entry was rendered, one byte each so parallel deliveries can set them
+    mutable std::vector<std::uint8_t> reportDirty_;
+    mutable OccupancyReportCache reportCache_;
+    FitIndex fitIndex_;  ///< Departments by free space for the placement policy
+    bool fitIndexed_;    ///< fitIndex_ is built for the current departments and policy, kept up to date from then on
+    DepartmentFactory departmentFactory_;  ///< Creates the departments of loaded states, makeDepartment() if empty
 };
 
 }  // namespace warehouse
\ No newline at end of file
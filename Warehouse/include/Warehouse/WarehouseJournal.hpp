@@ -0,0 +1,274 @@
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <Serialization/WriteAheadLog.hpp>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace warehouse
+{
+
+/**
+ * @brief Durability settings of a warehouse journal
+ */
+struct JournalOptions
+{
+    SyncPolicy sync = SyncPolicy::onCommit;           ///< When commits are forced to stable storage
+    std::size_t syncInterval = 16;                    ///< Commits per sync for SyncPolicy::periodic
+    std::size_t checkpointLogBytes = 64 * 1024 * 1024;  ///< Log size starting an automatic checkpoint, 0 to disable
+};
+
+/**
+ * @brief Snapshot plus operation log persistence of a warehouse
+ *
+ * The journal directory holds generations: snapshot.N is a binary snapshot of the state in which
+ * log.N starts. A checkpoint only closes the current log and opens the next generation, a
+ * background thread then folds the older snapshot and the closed logs into a new snapshot and
+ * removes them. The foreground cost of durability is therefore the size of the logged changes,
+ * not the size of the warehouse.
+ */
+class WarehouseJournal
+{
+public:
+    /// Builds snapshot.toGeneration from snapshot.fromGeneration and the logs in between
+    using Compactor = std::function<bool(const std::string &directory, std::uint64_t fromGeneration, std::uint64_t toGeneration)>;
+
+    WarehouseJournal(std::string directory, JournalOptions options, Compactor compact) :
+            directory_(std::move(directory)),
+            options_(options),
+            compact_(std::move(compact)),
+            log_(),
+            generation_(0),
+            snapshotGeneration_(0),
+            compaction_(),
+            compactionDone_(true),
+            healthy_(true)
+    {}
+
+    WarehouseJournal(const WarehouseJournal &) = delete;
+    WarehouseJournal &operator=(const WarehouseJournal &) = delete;
+
+    ~WarehouseJournal()
+    {
+        waitForCompaction();
+        log_.close();
+    }
+
+    static std::string snapshotPath(const std::string &directory, std::uint64_t generation)
+    {
+        return directory + "/snapshot." + std::to_string(generation);
+    }
+
+    static std::string logPath(const std::string &directory, std::uint64_t generation)
+    {
+        return directory + "/log." + std::to_string(generation);
+    }
+
+    /**
+     * @brief Find the newest snapshot of a journal directory
+     * @param directory Journal directory
+     * @return Generation of the newest snapshot, std::nullopt if there is none
+     */
+    static std::optional<std::uint64_t> latestSnapshot(const std::string &directory)
+    {
+        std::optional<std::uint64_t> latest{};
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+        {
+            const auto generation = parseGeneration(entry.path().filename().string(), "snapshot.");
+            if (generation && (!latest || *generation > *latest))
+                latest = generation;
+        }
+        return latest;
+    }
+
+    /**
+     * @brief Replace a file atomically and durably: write a temporary file, sync it and rename it
+     * @param path Destination file
+     * @param bytes New contents
+     * @return true if the file was replaced, false otherwise
+     */
+    static bool writeFile(const std::string &path, const std::string &bytes)
+    {
+        const auto temporary = path + ".tmp";
+        const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+
+        std::size_t written = 0;
+        while (written < bytes.size())
+        {
+            const auto result = ::write(fd, bytes.data() + written, bytes.size() - written);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                break;
+            written += static_cast<std::size_t>(result);
+        }
+        const bool synced = written == bytes.size() && ::fsync(fd) == 0;
+        ::close(fd);
+        if (!synced || ::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+
+        const auto parent = std::filesystem::path(path).parent_path().string();
+        const int dirFd = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd >= 0)
+        {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove the snapshots and logs of generations older than the given one
+     */
+    static void removeGenerationsBefore(const std::string &directory, std::uint64_t generation)
+    {
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+        {
+            const auto name = entry.path().filename().string();
+            auto older = parseGeneration(name, "snapshot.");
+            if (!older)
+                older = parseGeneration(name, "log.");
+            if (older && *older < generation)
+                std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    /**
+     * @brief Start logging on top of a full snapshot, dropping every older generation
+     * @param generation Generation of the snapshot, newer than any generation in the directory
+     * @param snapshot Binary snapshot of the current state
+     * @return true if the snapshot was written and the log opened, false otherwise
+     */
+    bool start(std::uint64_t generation, const std::string &snapshot)
+    {
+        waitForCompaction();
+        log_.close();
+
+        std::error_code error;
+        std::filesystem::create_directories(directory_, error);
+        std::filesystem::remove(logPath(directory_, generation), error);
+        healthy_ = writeFile(snapshotPath(directory_, generation), snapshot) &&
+                   log_.open(logPath(directory_, generation), options_.sync, options_.syncInterval);
+        if (healthy_)
+            removeGenerationsBefore(directory_, generation);
+
+        generation_ = generation;
+        snapshotGeneration_ = generation;
+        return healthy_;
+    }
+
+    std::uint64_t generation() const { return generation_; }
+
+    /**
+     * @brief false once a write or sync failed, the log may then miss operations
+     */
+    bool isHealthy() const { return healthy_; }
+
+    /**
+     * @brief Add a record to the current group commit
+     */
+    void append(const wal::Record &record) { log_.append(record); }
+
+    /**
+     * @brief Write the current group commit, checkpoint when the log grew past the configured size
+     * @return true if the records were written, false otherwise
+     */
+    bool commit()
+    {
+        healthy_ = log_.commit() && healthy_;
+        if (options_.checkpointLogBytes && log_.size() >= options_.checkpointLogBytes)
+            return checkpoint();
+        return healthy_;
+    }
+
+    /**
+     * @brief Close the current log, continue in a new generation and fold the closed logs in the background
+     * @return true if the new log was opened, false otherwise
+     */
+    bool checkpoint()
+    {
+        healthy_ = log_.commit() && healthy_;
+        log_.close();
+        ++generation_;
+        healthy_ = log_.open(logPath(directory_, generation_), options_.sync, options_.syncInterval) && healthy_;
+        startCompaction();
+        return healthy_;
+    }
+
+    /**
+     * @brief Block until the running background compaction, if any, finished
+     */
+    void waitForCompaction()
+    {
+        if (compaction_.joinable())
+            compaction_.join();
+    }
+
+private:
+    static std::optional<std::uint64_t> parseGeneration(const std::string &name, const std::string &prefix)
+    {
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+            return std::nullopt;
+
+        std::uint64_t generation = 0;
+        for (std::size_t i = prefix.size(); i < name.size(); ++i)
+        {
+            if (name[i] < '0' || name[i] > '9')
+                return std::nullopt;
+            generation = generation * 10 + static_cast<std::uint64_t>(name[i] - '0');
+        }
+        return generation;
+    }
+
+    /**
+     * @brief Fold the closed generations unless a compaction is still running, the next checkpoint covers them then
+     */
+    void startCompaction()
+    {
+        if (compaction_.joinable())
+        {
+            if (!compactionDone_)
+                return;
+            compaction_.join();
+        }
+
+        const auto from = snapshotGeneration_.load();
+        const auto to = generation_;
+        compactionDone_ = false;
+        compaction_ = std::thread([this, from, to]() {
+            if (compact_(directory_, from, to))
+                snapshotGeneration_ = to;
+            compactionDone_ = true;
+        });
+    }
+
+    const std::string directory_;                   ///< Journal directory
+    const JournalOptions options_;                  ///< Durability settings
+    const Compactor compact_;                       ///< Folds closed generations into a snapshot
+    WriteAheadLog log_;                             ///< Log of the current generation
+    std::uint64_t generation_;                      ///< Current generation
+    std::atomic<std::uint64_t> snapshotGeneration_; ///< Generation of the newest snapshot
+    std::thread compaction_;                        ///< Background compaction
+    std::atomic<bool> compactionDone_;              ///< compaction_ finished and can be joined
+    bool healthy_;                                  ///< No write or sync failed so far
+};
+
+}  // namespace warehouse
@@ -0,0 +1,111 @@
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/ProductsList.hpp>
+#include <Serialization/BinarySnapshot.hpp>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+void fillWarehouse(Warehouse &warehouse)
+{
+    ProductFactory productFactory{};
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(1000.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1000.3f));
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(7.0f));
+    warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(10.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("GlassWare", "Plate \"large\"", 0.1f));
+    products.emplace_back(productFactory.createProduct("GlassWare", "Zażółć", 12.25f));
+    for (int i = 0; i < 300; ++i)
+    {
+        products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack " + std::to_string(i % 40), 0.3f));
+    }
+    warehouse.newDelivery(std::move(products));
+    warehouse.newOrder("{\"order\": [{\"name\":\"Rack 7\"},{\"name\":\"Rack 20\"}]}");
+}
+}  // namespace
+
+TEST(BinarySnapshotTest, RoundTripsWithJson)
+{
+    Warehouse source{};
+    fillWarehouse(source);
+    const auto json = source.saveWarehouseState();
+    const auto binary = source.saveWarehouseStateBinary();
+    EXPECT_LT(binary.size() * 5, json.size());
+
+    Warehouse fromBinary{};
+    ASSERT_TRUE(fromBinary.loadWarehouseStateBinary(binary));
+    EXPECT_EQ(fromBinary.saveWarehouseState(), json);
+
+    Warehouse fromJson{};
+    ASSERT_TRUE(fromJson.loadWarehouseState(json));
+    EXPECT_EQ(fromJson.saveWarehouseStateBinary(), binary);
+}
+
+TEST(BinarySnapshotTest, EmptyWarehouse)
+{
+    Warehouse warehouse{};
+    const auto binary = warehouse.saveWarehouseStateBinary();
+    EXPECT_EQ(binary.size(), sizeof(snapshot::Header) + 8);
+    ASSERT_TRUE(warehouse.loadWarehouseStateBinary(binary));
+    EXPECT_EQ(warehouse.saveWarehouseState(), "{\"warehouseState\":[]}");
+}
+
+TEST(BinarySnapshotTest, RejectsCorruptedSnapshots)
+{
+    Warehouse source{};
+    fillWarehouse(source);
+    const auto binary = source.saveWarehouseStateBinary();
+    const auto json = source.saveWarehouseState();
+
+    auto flipped = binary;
+    flipped[flipped.size() / 2] ^= 0x40;
+    EXPECT_FALSE(source.loadWarehouseStateBinary(flipped));
+    EXPECT_FALSE(source.loadWarehouseStateBinary(binary.substr(0, binary.size() - 8)));
+    EXPECT_FALSE(source.loadWarehouseStateBinary(std::string()));
+
+    auto newerVersion = binary;
+    newerVersion[8] = static_cast<char>(snapshot::version + 1);
+    EXPECT_FALSE(source.loadWarehouseStateBinary(newerVersion));
+
+    // A matching checksum does not make out of range ids acceptable
+    auto badName = binary;
+    SnapshotReader reader;
+    ASSERT_TRUE(reader.open(binary.data(), binary.size()));
+    const std::uint32_t invalidId = 0xffffffffu;
+    const auto namesOffset = binary.size() - snapshot::aligned(reader.itemCount()) -
+                             snapshot::aligned(reader.itemCount() * sizeof(std::uint16_t)) -
+                             snapshot::aligned(reader.itemCount() * sizeof(std::uint32_t));
+    std::memcpy(&badName[namesOffset], &invalidId, sizeof(invalidId));
+    snapshot::Header header{};
+    std::memcpy(&header, badName.data(), sizeof(header));
+    header.checksum = snapshot::checksum(badName.data() + sizeof(header), badName.size() - sizeof(header));
+    std::memcpy(&badName[0], &header, sizeof(header));
+    EXPECT_FALSE(source.loadWarehouseStateBinary(badName));
+
+    EXPECT_EQ(source.saveWarehouseState(), json);
+}
+
+TEST(BinarySnapshotTest, UnknownDepartmentKeepsCurrentState)
+{
+    Warehouse warehouse{};
+    fillWarehouse(warehouse);
+    const auto json = warehouse.saveWarehouseState();
+
+    SnapshotWriter writer{};
+    writer.beginDepartment("ColdRoomDepartment", 10.0f);
+    writer.addItem(writer.productClass("AstronautsIceCream"), "Vanilla", 1.0f, 0);
+    writer.beginDepartment("FreezerDepartment", 10.0f);
+    EXPECT_FALSE(warehouse.loadWarehouseStateBinary(writer.finish()));
+
+    EXPECT_EQ(warehouse.saveWarehouseState(), json);
+}
+
+}  // namespace warehouse
@@ -0,0 +1,249 @@
+#include <PicoJson/picojson.h>
+#include <gtest/gtest.h>
+
+#include <Departments/ConcurrentHazardousDepartment.hpp>
+#include <Departments/ConcurrentSpecialDepartment.hpp>
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <Warehouse/ConcurrentWarehouse.hpp>
+#include <Warehouse/Warehouse.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+template <typename WarehouseType>
+void addDepartments(WarehouseType &warehouse)
+{
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(300.0f));
+}
+
+std::vector<warehouseInterface::IProductPtr> racks(const std::string &prefix, int count)
+{
+    std::vector<warehouseInterface::IProductPtr> products{};
+    for (int i = 0; i < count; ++i)
+        products.push_back(std::make_unique<IndustrialServerRack>(prefix + std::to_string(i), 0.5f));
+    return products;
+}
+
+/**
+ * @brief Sum the item sizes of every department of a saved state
+ */
+std::vector<double> storedSizes(const std::string &state)
+{
+    picojson::value val;
+    picojson::parse(val, state);
+    std::vector<double> sizes{};
+    for (const auto &department : val.get("warehouseState").get<picojson::array>())
+    {
+        double size = 0.0;
+        for (const auto &item : department.get("items").get<picojson::array>())
+            size += item.get("size").get<double>();
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+/**
+ * @brief Department counting its destruction
+ */
+template <typename Department>
+class Counted : public Department
+{
+public:
+    Counted(std::atomic<int> &destroyed, float maxOccupancy) : Department(maxOccupancy), destroyed_(destroyed) {}
+    Counted(const Counted &) = delete;
+    Counted &operator=(const Counted &) = delete;
+    ~Counted() override { ++destroyed_; }
+
+private:
+    std::atomic<int> &destroyed_;
+};
+
+std::vector<double> reportedOccupancy(const std::string &report)
+{
+    picojson::value val;
+    picojson::parse(val, report);
+    std::vector<double> occupancy{};
+    for (const auto &department : val.get("departmentsOccupancy").get<picojson::array>())
+        occupancy.push_back(department.get("occupancy").get<double>());
+    return occupancy;
+}
+}  // namespace
+
+TEST(ConcurrentWarehouseTest, BehavesLikeWarehouseOnOneThread)
+{
+    Warehouse plain{};
+    ConcurrentWarehouse concurrent{};
+    addDepartments(plain);
+    addDepartments(concurrent);
+
+    EXPECT_EQ(concurrent.newDelivery(racks("Rack ", 900)), plain.newDelivery(racks("Rack ", 900)));
+    const std::string order = "{\"order\": [{\"name\":\"Rack 3\"},{\"class\":\"IndustrialServerRack\"},{\"name\":\"Missing\"}]}";
+    EXPECT_EQ(concurrent.newOrder(order).products.size(), plain.newOrder(order).products.size());
+    EXPECT_EQ(concurrent.getOccupancyReport(), plain.getOccupancyReport());
+    EXPECT_EQ(concurrent.saveWarehouseState(), plain.saveWarehouseState());
+
+    ConcurrentWarehouse loaded{};
+    ASSERT_TRUE(loaded.loadWarehouseState(plain.saveWarehouseState()));
+    EXPECT_EQ(loaded.saveWarehouseState(), plain.saveWarehouseState());
+    EXPECT_EQ(loaded.getOccupancyReport(), plain.getOccupancyReport());
+    EXPECT_FALSE(loaded.loadWarehouseState("{\"warehouseState\": [{\"class\":\"Unknown\"}]}"));
+    EXPECT_EQ(loaded.saveWarehouseState(), plain.saveWarehouseState());
+}
+
+TEST(ConcurrentWarehouseTest, OccupancyStaysConsistentUnderContention)
+{
+    ConcurrentWarehouse warehouse{};
+    addDepartments(warehouse);
+
+    constexpr int threadCount = 8;
+    constexpr int rounds = 50;
+    constexpr int batch = 40;
+    std::atomic<bool> done{false};
+    std::atomic<int> delivered{0};
+    std::atomic<int> taken{0};
+
+    // Reports are read without locks while the departments change
+    std::thread reporter([&warehouse, &done]() {
+        while (!done.load())
+        {
+            for (const auto occupancy : reportedOccupancy(warehouse.getOccupancyReport()))
+            {
+                EXPECT_GE(occupancy, 0.0);
+                EXPECT_LE(occupancy, 300.0);
+            }
+        }
+    });
+
+    std::vector<std::thread> workers{};
+    for (int t = 0; t < threadCount; ++t)
+    {
+        workers.emplace_back([&warehouse, &delivered, &taken, t]() {
+            for (int round = 0; round < rounds; ++round)
+            {
+                const auto prefix = "Rack " + std::to_string(t) + "-" + std::to_string(round) + "-";
+                picojson::value report;
+                picojson::parse(report, warehouse.newDelivery(racks(prefix, batch)));
+                for (const auto &delivery : report.get("deliveryReport").get<picojson::array>())
+                    delivered += delivery.get("status").get<std::string>() == "Success";
+
+                std::string order = "{\"order\": [";
+                for (int i = 0; i < batch; i += 2)
+                    order += (i ? ",{\"name\":\"" : "{\"name\":\"") + prefix + std::to_string(i) + "\"}";
+                order += "]}";
+                taken += static_cast<int>(warehouse.newOrder(order).products.size());
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    done = true;
+    reporter.join();
+
+    // Every stored item is accounted for in the occupancy of its department
+    const auto occupancy = reportedOccupancy(warehouse.getOccupancyReport());
+    const auto stored = storedSizes(warehouse.saveWarehouseState());
+    ASSERT_EQ(occupancy.size(), stored.size());
+    double total = 0.0;
+    for (std::size_t i = 0; i < stored.size(); ++i)
+    {
+        EXPECT_DOUBLE_EQ(occupancy[i], stored[i]);
+        total += stored[i];
+    }
+    EXPECT_GT(taken.load(), 0);
+    EXPECT_DOUBLE_EQ(total, 0.5 * (delivered.load() - taken.load()));
+}
+
+TEST(ConcurrentWarehouseTest, LoadFreesReplacedDepartments)
+{
+    std::atomic<int> destroyed{0};
+    ConcurrentWarehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<Counted<SpecialDepartment>>(destroyed, 100.0f));
+    warehouse.addDepartment(std::make_unique<Counted<ConcurrentSpecialDepartment>>(destroyed, 100.0f));
+    for (int i = 0; i < 200; ++i)
+        warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(1.0f));
+    warehouse.newDelivery(racks("Rack ", 4));
+
+    Warehouse plain{};
+    addDepartments(plain);
+    const auto state = plain.saveWarehouseState();
+
+    // Reports hold the layout they read while loads replace it
+    std::atomic<bool> loading{true};
+    std::thread reader([&warehouse, &loading]() {
+        while (loading.load())
+            EXPECT_FALSE(warehouse.getOccupancyReport().empty());
+    });
+    for (int i = 0; i < 50; ++i)
+        ASSERT_TRUE(warehouse.loadWarehouseState(state));
+    loading = false;
+    reader.join();
+
+    EXPECT_EQ(destroyed.load(), 2);
+    EXPECT_EQ(warehouse.saveWarehouseState(), state);
+}
+
+TEST(ConcurrentWarehouseTest, RoundTripKeepsLockFreeDepartments)
+{
+    ConcurrentWarehouse warehouse(ConcurrentWarehouse::lockFreeDepartmentFactory());
+    warehouse.addDepartment(std::make_unique<ConcurrentSpecialDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<ConcurrentHazardousDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(100.0f));
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.push_back(std::make_unique<GlassWare>("Glass", 1.0f));
+    products.push_back(std::make_unique<ExplosiveBarrel>("TNT", 2.0f));
+    products.push_back(std::make_unique<IndustrialServerRack>("Rack", 3.0f));
+    warehouse.newDelivery(std::move(products));
+
+    const auto state = warehouse.saveWarehouseState();
+    ASSERT_TRUE(warehouse.loadWarehouseState(state));
+    EXPECT_EQ(warehouse.saveWarehouseState(), state);
+
+    std::vector<bool> lockFree{};
+    warehouse.forEachDepartment([&lockFree](const warehouseInterface::IDepartment &department) {
+        lockFree.push_back(dynamic_cast<const ConcurrentDepartment *>(&department) != nullptr);
+    });
+    EXPECT_EQ(lockFree, (std::vector<bool>{true, true, false}));
+
+    // Without the factory the same state comes back mutex-backed
+    ConcurrentWarehouse plain{};
+    ASSERT_TRUE(plain.loadWarehouseState(state));
+    lockFree.clear();
+    plain.forEachDepartment([&lockFree](const warehouseInterface::IDepartment &department) {
+        lockFree.push_back(dynamic_cast<const ConcurrentDepartment *>(&department) != nullptr);
+    });
+    EXPECT_EQ(lockFree, (std::vector<bool>{false, false, false}));
+}
+
+TEST(ConcurrentWarehouseTest, FirstFitHoldsUnderContention)
+{
+    ConcurrentWarehouse warehouse{};
+    addDepartments(warehouse);
+
+    // 400 racks of 0.5 fill the first department and spill 100 into the last one
+    std::vector<std::thread> workers{};
+    for (int t = 0; t < 8; ++t)
+    {
+        workers.emplace_back([&warehouse, t]() {
+            for (int i = 0; i < 50; ++i)
+                warehouse.newDelivery(racks("Rack " + std::to_string(t) + "-" + std::to_string(i), 1));
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    const auto occupancy = reportedOccupancy(warehouse.getOccupancyReport());
+    ASSERT_EQ(occupancy.size(), 3);
+    EXPECT_DOUBLE_EQ(occupancy[0], 100.0);
+    EXPECT_DOUBLE_EQ(occupancy[1], 0.0);
+    EXPECT_DOUBLE_EQ(occupancy[2], 100.0);
+}
+
+}  // namespace warehouse
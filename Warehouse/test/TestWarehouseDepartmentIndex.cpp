@@ -0,0 +1,103 @@
+#include <PicoJson/picojson.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Interfaces/IProduct.hpp>
+#include <Products/BasicProduct.hpp>
+#include <Products/ProductsList.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+struct ReferenceItem
+{
+    std::string className;
+    std::string name;
+    warehouseInterface::IProduct *product;
+};
+
+warehouseInterface::IProductPtr makePart(int kind, const std::string &name)
+{
+    if (kind == 0)
+        return std::make_unique<IndustrialServerRack>(name, 0.5f);
+    return std::make_unique<BasicProduct>(name, 0.5f, warehouseInterface::ProductLabelFlags::esdSensitive);
+}
+}  // namespace
+
+TEST(DepartmentIndexTest, OldestMatchWinsAfterManyRemovals)
+{
+    OverSizeElectronicDepartment department(100000.0f);
+    std::vector<ReferenceItem> reference{};
+    std::mt19937 generator(42);
+
+    for (int round = 0; round < 8000; ++round)
+    {
+        if (round < 4000 && generator() % 3 != 0)
+        {
+            const int kind = static_cast<int>(generator() % 2);
+            const auto name = std::to_string(generator() % 5);
+            auto product = makePart(kind, name);
+            auto *base = dynamic_cast<BaseProduct *>(product.get());
+            reference.push_back({base->getClassName(), name, product.get()});
+            ASSERT_TRUE(department.addItem(std::move(product)));
+            continue;
+        }
+
+        picojson::object query;
+        const auto mode = generator() % 4;
+        if (mode == 0 || mode == 2)
+            query["class"] = picojson::value(generator() % 2 ? "IndustrialServerRack" : "BasicProduct");
+        if (mode == 1 || mode == 2)
+            query["name"] = picojson::value(std::to_string(generator() % 5));
+
+        auto expected = std::find_if(reference.begin(), reference.end(), [&query](const ReferenceItem &item) {
+            if (query.count("class") && query.at("class").get<std::string>() != item.className)
+                return false;
+            if (query.count("name") && query.at("name").get<std::string>() != item.name)
+                return false;
+            return true;
+        });
+
+        auto taken = department.getItem(picojson::value(query).serialize());
+        if (expected == reference.end())
+        {
+            EXPECT_EQ(taken, nullptr);
+            continue;
+        }
+        ASSERT_NE(taken, nullptr);
+        EXPECT_EQ(taken.get(), expected->product);
+        reference.erase(expected);
+    }
+
+    EXPECT_FLOAT_EQ(department.getOccupancy(), 0.5f * static_cast<float>(reference.size()));
+}
+
+TEST(DepartmentIndexTest, SerializeSkipsTakenItems)
+{
+    ColdRoomDepartment department(20.0f);
+    department.addItem(std::make_unique<BasicProduct>("Vanilla", 0.5f, warehouseInterface::ProductLabelFlags::keepFrozen));
+    department.addItem(std::make_unique<BasicProduct>("Chocolate", 1.5f, warehouseInterface::ProductLabelFlags::keepFrozen));
+    department.addItem(std::make_unique<BasicProduct>("Apple", 1.0f, warehouseInterface::ProductLabelFlags::keepFrozen));
+
+    auto item = department.getItem("{\"name\": \"Chocolate\"}");
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(item->name(), "Chocolate");
+    EXPECT_EQ(department.getItem("{\"name\": \"Chocolate\"}"), nullptr);
+
+    EXPECT_EQ(department.serialize(),
+              "{\"class\":\"ColdRoomDepartment\",\"items\":[{\"class\":\"BasicProduct\",\"flags\":[\"keepFrozen\"],\"name\":"
+              "\"Vanilla\",\"size\":0.5},{\"class\":\"BasicProduct\",\"flags\":[\"keepFrozen\"],\"name\":\"Apple\",\"size\":1}],"
+              "\"maxOccupancy\":20,\"occupancy\":1.5}");
+
+    item = department.getItem("{}");
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(item->name(), "Vanilla");
+    EXPECT_FLOAT_EQ(department.getOccupancy(), 1.0f);
+}
+
+}  // namespace warehouse
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Departments/ItemStore.hpp>
+#include <Products/ProductsList.hpp>
+#include <Serialization/JsonSink.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+class ForeignProduct : public warehouseInterface::IProduct
+{
+public:
+    std::string name() const override { return "Foreign"; }
+    float itemSize() const override { return 2.0f; }
+    warehouseInterface::ProductLabelFlags itemFlags() const override { return warehouseInterface::ProductLabelFlags::fragile; }
+    picojson::object asJson() const override { return picojson::object{}; }
+    warehouseInterface::ProductDescriptionJson serialize() const override { return "{\"foreign\":true}"; }
+};
+
+std::vector<std::string> names(const ItemStore &store)
+{
+    std::vector<std::string> result{};
+    store.forEach([&store, &result](ItemStore::Position position) { result.emplace_back(store.name(position)); });
+    return result;
+}
+}  // namespace
+
+TEST(ItemStoreTest, KeepsColumnsAndHandsOutStoredProducts)
+{
+    ItemStore store;
+    auto glass = std::make_unique<GlassWare>("Glass", 1.5f);
+    auto *glassPtr = glass.get();
+    const auto glassPosition = store.push(std::move(glass));
+    const auto foreignPosition = store.push(std::make_unique<ForeignProduct>());
+
+    EXPECT_EQ(store.className(glassPosition), "GlassWare");
+    EXPECT_EQ(store.name(glassPosition), "Glass");
+    EXPECT_FLOAT_EQ(store.itemSize(glassPosition), 1.5f);
+    EXPECT_EQ(store.itemFlags(glassPosition), glassPtr->itemFlags());
+    EXPECT_EQ(store.classSymbol(foreignPosition), noSymbol);
+    EXPECT_DOUBLE_EQ(store.occupancy(), 3.5);
+
+    EXPECT_TRUE(store.matches(ProductQuery{std::string("GlassWare"), std::string("Glass")}.symbols(), glassPosition));
+    EXPECT_FALSE(store.matches(ProductQuery{std::string("GlassWare"), std::nullopt}.symbols(), foreignPosition));
+    EXPECT_TRUE(store.matches(ProductQuery{std::nullopt, std::string("Foreign")}.symbols(), foreignPosition));
+
+    JsonSink sink;
+    sink.beginArray();
+    store.writeJson(sink, glassPosition);
+    store.writeJson(sink, foreignPosition);
+    sink.endArray();
+    EXPECT_EQ(sink.release(), "[" + glassPtr->serialize() + ",{\"foreign\":true}]");
+
+    EXPECT_EQ(store.take(glassPosition).get(), glassPtr);
+    EXPECT_FALSE(store.isLive(glassPosition));
+    EXPECT_EQ(store.front(), foreignPosition);
+    EXPECT_DOUBLE_EQ(store.occupancy(), 2.0);
+}
+
+TEST(ItemStoreTest, DropsTombstonesAndKeepsOrder)
+{
+    ItemStore store;
+    for (int i = 0; i < 200; ++i)
+        store.push(std::make_unique<TV>("TV " + std::to_string(i), 1.0f));
+
+    // Interior removals leave tombstones, removals at the ends move front() and back()
+    for (ItemStore::Position position = 10; position < 190; position += 2)
+        store.take(position);
+    store.take(199);
+    store.take(0);
+    EXPECT_EQ(store.front(), 1);
+    EXPECT_EQ(store.back(), 198);
+    EXPECT_EQ(store.tombstones(), 90);
+
+    const auto before = names(store);
+    store.compact();
+    EXPECT_EQ(store.tombstones(), 0);
+    EXPECT_EQ(store.slots(), before.size());
+    EXPECT_EQ(names(store), before);
+    EXPECT_EQ(store.name(store.front()), "TV 1");
+    EXPECT_EQ(store.name(store.back()), "TV 198");
+    EXPECT_DOUBLE_EQ(store.occupancy(), static_cast<double>(before.size()));
+
+    while (!store.empty())
+        store.take(store.back());
+    EXPECT_EQ(store.slots(), 0);
+    EXPECT_EQ(store.tombstones(), 0);
+}
+
+TEST(ItemStoreTest, DepartmentRecalculatesOccupancy)
+{
+    SmallElectronicDepartment department(1000.0f);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_TRUE(department.addItem(std::make_unique<IndustrialServerRack>("Rack", 0.1f)));
+    for (int i = 0; i < 500; ++i)
+        ASSERT_NE(department.getItem("{\"name\":\"Rack\"}"), nullptr);
+
+    EXPECT_NEAR(department.recalculateOccupancy(), 50.0f, 1e-4f);
+    EXPECT_NEAR(department.getOccupancy(), 50.0f, 1e-4f);
+}
+
+TEST(ItemStoreTest, OccupancyDoesNotDriftUnderChurn)
+{
+    SmallElectronicDepartment department(1.0f);
+    const float sizes[] = {0.1f, 0.3f, 0.7f, 0.01f, 0.33f};
+    ASSERT_TRUE(department.addItem(std::make_unique<IndustrialServerRack>("Resident", 0.1f)));
+    for (int cycle = 0; cycle < 1000000; ++cycle)
+    {
+        ASSERT_TRUE(department.addItem(std::make_unique<IndustrialServerRack>("Rack", sizes[cycle % 5])));
+        ASSERT_NE(department.takeItem(ProductQuery{std::nullopt, std::string("Rack")}), nullptr);
+    }
+    EXPECT_EQ(department.occupancyUnits(), occupancyUnitsPerSize / 10);
+    ASSERT_NE(department.takeItem(ProductQuery{}), nullptr);
+    EXPECT_EQ(department.occupancyUnits(), 0);
+    EXPECT_EQ(department.getOccupancy(), 0.0f);
+
+    // Ten items of 0.1 fill the department exactly, a float running sum would reject the last one
+    for (int i = 0; i < 10; ++i)
+        ASSERT_TRUE(department.addItem(std::make_unique<IndustrialServerRack>("Rack", 0.1f)));
+    EXPECT_FALSE(department.addItem(std::make_unique<IndustrialServerRack>("Rack", 0.01f)));
+    EXPECT_EQ(department.getOccupancy(), 1.0f);
+    EXPECT_EQ(department.getOccupancy(), department.recalculateOccupancy());
+}
+
+}  // namespace warehouse
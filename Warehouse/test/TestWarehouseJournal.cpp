@@ -0,0 +1,200 @@
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/ProductsList.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+std::string journalDirectory(const std::string &name)
+{
+    const auto directory = ::testing::TempDir() + "warehouse_journal_" + name;
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+std::vector<warehouseInterface::IProductPtr> delivery(int first, int count)
+{
+    ProductFactory productFactory{};
+    std::vector<warehouseInterface::IProductPtr> products{};
+    for (int i = first; i < first + count; ++i)
+    {
+        products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack " + std::to_string(i % 5), 0.5f));
+        products.emplace_back(productFactory.createProduct("GlassWare", "Glass " + std::to_string(i % 3), 1.5f));
+    }
+    return products;
+}
+
+void populate(Warehouse &warehouse, int first)
+{
+    warehouse.newDelivery(delivery(first, 10));
+    warehouse.newOrder("{\"order\": [{\"name\":\"Rack 3\"},{\"class\":\"GlassWare\"},{\"name\":\"Missing\"}]}");
+    warehouse.newDelivery(delivery(first + 10, 4));
+    warehouse.newOrder("{\"order\": [{\"class\":\"IndustrialServerRack\",\"name\":\"Rack 1\"},{\"name\":\"Glass 2\"}]}");
+}
+
+void addDepartments(Warehouse &warehouse)
+{
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(1000.0f));
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(3.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1000.0f));
+}
+}  // namespace
+
+TEST(JournalTest, RecoversJournaledOperations)
+{
+    const auto directory = journalDirectory("recover");
+    std::string expected;
+    {
+        Warehouse warehouse{};
+        ASSERT_TRUE(warehouse.openJournal(directory));
+        addDepartments(warehouse);
+        populate(warehouse, 0);
+        EXPECT_TRUE(warehouse.isJournalHealthy());
+        expected = warehouse.saveWarehouseState();
+    }
+
+    Warehouse recovered{};
+    ASSERT_TRUE(recovered.openJournal(directory));
+    EXPECT_EQ(recovered.saveWarehouseState(), expected);
+
+    // The recovered warehouse keeps journaling on top of the recovered state
+    populate(recovered, 20);
+    expected = recovered.saveWarehouseState();
+    recovered.closeJournal();
+
+    Warehouse again{};
+    ASSERT_TRUE(again.openJournal(directory));
+    EXPECT_EQ(again.saveWarehouseState(), expected);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(JournalTest, CheckpointFoldsLogIntoSnapshot)
+{
+    const auto directory = journalDirectory("checkpoint");
+    Warehouse warehouse{};
+    ASSERT_TRUE(warehouse.openJournal(directory, JournalOptions{SyncPolicy::none, 1, 0}));
+    addDepartments(warehouse);
+    populate(warehouse, 0);
+
+    ASSERT_TRUE(warehouse.checkpointJournal());
+    populate(warehouse, 30);
+    warehouse.waitForJournalCompaction();
+
+    EXPECT_TRUE(std::filesystem::exists(WarehouseJournal::snapshotPath(directory, 2)));
+    EXPECT_TRUE(std::filesystem::exists(WarehouseJournal::logPath(directory, 2)));
+    EXPECT_FALSE(std::filesystem::exists(WarehouseJournal::snapshotPath(directory, 1)));
+    EXPECT_FALSE(std::filesystem::exists(WarehouseJournal::logPath(directory, 1)));
+
+    const auto expected = warehouse.saveWarehouseState();
+    warehouse.closeJournal();
+    Warehouse recovered{};
+    ASSERT_TRUE(recovered.openJournal(directory));
+    EXPECT_EQ(recovered.saveWarehouseState(), expected);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(JournalTest, RecoversSizeRangedOrders)
+{
+    const auto directory = journalDirectory("sizes");
+    std::string expected;
+    {
+        Warehouse warehouse{};
+        ASSERT_TRUE(warehouse.openJournal(directory));
+        warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1000.0f));
+        std::vector<warehouseInterface::IProductPtr> products{};
+        products.push_back(std::make_unique<IndustrialServerRack>("Big", 9.0f));
+        products.push_back(std::make_unique<IndustrialServerRack>("Small", 1.0f));
+        products.push_back(std::make_unique<IndustrialServerRack>("Big", 9.0f));
+        products.push_back(std::make_unique<IndustrialServerRack>("Small", 1.0f));
+        warehouse.newDelivery(std::move(products));
+
+        // Without its range either order would take the first rack stored, a big one
+        const std::string order = "{\"order\": [{\"class\":\"IndustrialServerRack\",\"maxSize\":2}]}";
+        ASSERT_EQ(warehouse.newOrder(order).products.size(), 1);
+        ASSERT_EQ(warehouse.newOrders({order}).front().products.size(), 1);
+        expected = warehouse.saveWarehouseState();
+    }
+    EXPECT_EQ(expected.find("Small"), std::string::npos);
+
+    Warehouse recovered{};
+    ASSERT_TRUE(recovered.openJournal(directory));
+    EXPECT_EQ(recovered.saveWarehouseState(), expected);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(JournalTest, IgnoresTornLogTail)
+{
+    const auto directory = journalDirectory("torn");
+    std::string expected;
+    {
+        Warehouse warehouse{};
+        ASSERT_TRUE(warehouse.openJournal(directory, JournalOptions{SyncPolicy::periodic, 4, 0}));
+        addDepartments(warehouse);
+        populate(warehouse, 0);
+        expected = warehouse.saveWarehouseState();
+    }
+
+    std::ofstream log(WarehouseJournal::logPath(directory, 1), std::ios::binary | std::ios::app);
+    log.write("\x20\x00\x00\x00\x01\x02", 6);
+    log.close();
+
+    Warehouse recovered{};
+    ASSERT_TRUE(recovered.openJournal(directory));
+    EXPECT_EQ(recovered.saveWarehouseState(), expected);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(JournalTest, LoadStartsNewGeneration)
+{
+    const auto directory = journalDirectory("load");
+    Warehouse source{};
+    addDepartments(source);
+    populate(source, 0);
+
+    Warehouse warehouse{};
+    ASSERT_TRUE(warehouse.openJournal(directory));
+    warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(10.0f));
+    ASSERT_TRUE(warehouse.loadWarehouseState(source.saveWarehouseState()));
+
+    EXPECT_TRUE(std::filesystem::exists(WarehouseJournal::snapshotPath(directory, 2)));
+    EXPECT_FALSE(std::filesystem::exists(WarehouseJournal::logPath(directory, 1)));
+    warehouse.newOrder("{\"order\": [{\"name\":\"Rack 0\"}]}");
+
+    const auto expected = warehouse.saveWarehouseState();
+    warehouse.closeJournal();
+    Warehouse recovered{};
+    ASSERT_TRUE(recovered.openJournal(directory));
+    EXPECT_EQ(recovered.saveWarehouseState(), expected);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(JournalTest, LoadFailsWhenNewGenerationCannotBeWritten)
+{
+    const auto directory = journalDirectory("unwritable");
+    Warehouse source{};
+    addDepartments(source);
+    populate(source, 0);
+
+    Warehouse warehouse{};
+    ASSERT_TRUE(warehouse.openJournal(directory));
+    EXPECT_TRUE(warehouse.isJournalHealthy());
+
+    // A plain file in place of the directory makes every journal write fail
+    std::filesystem::remove_all(directory);
+    std::ofstream(directory) << "not a directory";
+    EXPECT_FALSE(warehouse.loadWarehouseState(source.saveWarehouseState()));
+    EXPECT_FALSE(warehouse.isJournalHealthy());
+
+    warehouse.closeJournal();
+    std::filesystem::remove_all(directory);
+}
+
+}  // namespace warehouse
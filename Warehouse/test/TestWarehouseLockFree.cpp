@@ -0,0 +1,255 @@
+#include <PicoJson/picojson.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Departments/LockFreeItemQueue.hpp>
+#include <Departments/LockFreeItemStack.hpp>
+#include <Products/BasicProduct.hpp>
+#include <Products/ProductsList.hpp>
+#include <Warehouse/ConcurrentWarehouse.hpp>
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+constexpr int producers = 4;
+constexpr int itemsPerProducer = 2000;
+
+warehouseInterface::IProductPtr hazardous(const std::string &name, float size)
+{
+    return std::make_unique<BasicProduct>(name, size, warehouseInterface::ProductLabelFlags::explosives);
+}
+
+/**
+ * @brief Push itemsPerProducer products named "<producer> <index>" from every producer while consumers drain the container
+ * @return Names in the order each consumer took them, one vector per consumer
+ */
+template <typename Container>
+std::vector<std::vector<std::string>> exchange(Container &container)
+{
+    std::atomic<int> taken{0};
+    std::vector<std::vector<std::string>> consumed(producers);
+    std::vector<std::thread> threads{};
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&container, producer]() {
+            for (int i = 0; i < itemsPerProducer; ++i)
+            {
+                const auto name = std::to_string(producer) + " " + std::to_string(i);
+                warehouseInterface::IProductPtr product = hazardous(name, 1.0f);
+                const auto symbol = StringInterner::global().intern(name);
+                while (!container.push(product, noSymbol, symbol))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &names : consumed)
+    {
+        threads.emplace_back([&container, &taken, &names]() {
+            while (taken.load() < producers * itemsPerProducer)
+            {
+                auto product = container.popIf([](Symbol, Symbol) { return true; });
+                if (!product)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                names.push_back(product->name());
+                taken.fetch_add(1);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    return consumed;
+}
+
+void expectEveryItemOnce(const std::vector<std::vector<std::string>> &consumed)
+{
+    std::set<std::string> names{};
+    std::size_t count = 0;
+    for (const auto &consumer : consumed)
+    {
+        names.insert(consumer.begin(), consumer.end());
+        count += consumer.size();
+    }
+    EXPECT_EQ(count, static_cast<std::size_t>(producers * itemsPerProducer));
+    EXPECT_EQ(names.size(), count);
+}
+}  // namespace
+
+TEST(LockFreeItemQueueTest, KeepsOrderOfEveryProducer)
+{
+    LockFreeItemQueue queue(256);
+    const auto consumed = exchange(queue);
+    expectEveryItemOnce(consumed);
+    EXPECT_TRUE(queue.empty());
+
+    // A consumer sees the items of one producer in the order they were pushed
+    for (const auto &names : consumed)
+    {
+        std::vector<int> last(producers, -1);
+        for (const auto &name : names)
+        {
+            const auto producer = std::stoi(name.substr(0, name.find(' ')));
+            const auto index = std::stoi(name.substr(name.find(' ') + 1));
+            EXPECT_LT(last[static_cast<std::size_t>(producer)], index);
+            last[static_cast<std::size_t>(producer)] = index;
+        }
+    }
+}
+
+TEST(LockFreeItemQueueTest, TakesOnlyMatchingOldestItem)
+{
+    LockFreeItemQueue queue(2);
+    auto &interner = StringInterner::global();
+    for (const auto *name : {"first", "second"})
+    {
+        warehouseInterface::IProductPtr product = hazardous(name, 1.0f);
+        EXPECT_TRUE(queue.push(product, noSymbol, interner.intern(name)));
+        EXPECT_EQ(product, nullptr);
+    }
+    warehouseInterface::IProductPtr rejected = hazardous("third", 1.0f);
+    EXPECT_FALSE(queue.push(rejected, noSymbol, interner.intern("third")));
+    EXPECT_NE(rejected, nullptr);
+
+    const auto second = interner.intern("second");
+    EXPECT_EQ(queue.popIf([second](Symbol, Symbol name) { return name == second; }), nullptr);
+    EXPECT_EQ(queue.popIf([](Symbol, Symbol) { return true; })->name(), "first");
+    EXPECT_EQ(queue.popIf([second](Symbol, Symbol name) { return name == second; })->name(), "second");
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeItemStackTest, TakesEveryItemOnce)
+{
+    LockFreeItemStack stack(256);
+    expectEveryItemOnce(exchange(stack));
+    EXPECT_TRUE(stack.empty());
+}
+
+TEST(LockFreeItemStackTest, TakesOnlyMatchingNewestItem)
+{
+    LockFreeItemStack stack(2);
+    auto &interner = StringInterner::global();
+    for (const auto *name : {"first", "second"})
+    {
+        warehouseInterface::IProductPtr product = hazardous(name, 1.0f);
+        EXPECT_TRUE(stack.push(product, noSymbol, interner.intern(name)));
+    }
+    warehouseInterface::IProductPtr rejected = hazardous("third", 1.0f);
+    EXPECT_FALSE(stack.push(rejected, noSymbol, interner.intern("third")));
+
+    std::vector<std::string> visited{};
+    stack.forEach([&visited](const warehouseInterface::IProduct &product, Symbol, Symbol) { visited.push_back(product.name()); });
+    EXPECT_EQ(visited, (std::vector<std::string>{"first", "second"}));
+
+    const auto first = interner.intern("first");
+    EXPECT_EQ(stack.popIf([first](Symbol, Symbol name) { return name == first; }), nullptr);
+    EXPECT_EQ(stack.popIf([](Symbol, Symbol) { return true; })->name(), "second");
+    EXPECT_EQ(stack.popIf([first](Symbol, Symbol name) { return name == first; })->name(), "first");
+    EXPECT_TRUE(stack.empty());
+}
+
+TEST(LockFreeDepartmentTest, BehavesLikeHazardousDepartment)
+{
+    HazardousDepartment reference(10.0f);
+    ConcurrentHazardousDepartment department(10.0f);
+    for (int i = 0; i < 6; ++i)
+    {
+        const auto name = "Barrel " + std::to_string(i);
+        EXPECT_EQ(department.addItem(hazardous(name, 2.0f)), reference.addItem(hazardous(name, 2.0f)));
+    }
+    EXPECT_FALSE(department.addItem(std::make_unique<GlassWare>("Glass", 0.1f)));
+    EXPECT_EQ(department.serialize(), reference.serialize());
+
+    for (const auto *description : {R"({"name":"Barrel 1"})", R"({"name":"Barrel 0"})", R"({"class":"BasicProduct"})", "{}"})
+    {
+        const auto expected = reference.getItem(description);
+        const auto taken = department.getItem(description);
+        ASSERT_EQ(taken == nullptr, expected == nullptr) << description;
+        if (taken)
+        {
+            EXPECT_EQ(taken->name(), expected->name());
+        }
+    }
+    EXPECT_FLOAT_EQ(department.getOccupancy(), reference.getOccupancy());
+    EXPECT_EQ(department.serialize(), reference.serialize());
+}
+
+TEST(LockFreeDepartmentTest, BehavesLikeSpecialDepartment)
+{
+    SpecialDepartment reference(10.0f);
+    ConcurrentSpecialDepartment department(10.0f);
+    for (int i = 0; i < 6; ++i)
+    {
+        const auto name = "Glass " + std::to_string(i);
+        EXPECT_EQ(department.addItem(std::make_unique<GlassWare>(name, 2.0f)), reference.addItem(std::make_unique<GlassWare>(name, 2.0f)));
+    }
+    EXPECT_EQ(department.serialize(), reference.serialize());
+    EXPECT_EQ(department.asJson(), reference.asJson());
+
+    for (const auto *description : {R"({"name":"Glass 0"})", R"({"class":"GlassWare","name":"Glass 4"})", R"({"class":"TV"})", "{}"})
+    {
+        const auto expected = reference.getItem(description);
+        const auto taken = department.getItem(description);
+        ASSERT_EQ(taken == nullptr, expected == nullptr) << description;
+        if (taken)
+        {
+            EXPECT_EQ(taken->name(), expected->name());
+        }
+    }
+    EXPECT_FLOAT_EQ(department.getOccupancy(), reference.getOccupancy());
+    EXPECT_EQ(department.serialize(), reference.serialize());
+}
+
+TEST(LockFreeDepartmentTest, OccupancyStaysWithinLimitUnderContention)
+{
+    ConcurrentWarehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<ConcurrentHazardousDepartment>(100.0f, 64));
+    warehouse.addDepartment(std::make_unique<ConcurrentSpecialDepartment>(100.0f, 64));
+
+    std::atomic<bool> overfilled{false};
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&warehouse, &overfilled, t]() {
+            for (int i = 0; i < 300; ++i)
+            {
+                const auto name = std::to_string(t) + " " + std::to_string(i);
+                std::vector<warehouseInterface::IProductPtr> products{};
+                products.push_back(hazardous(name, 3.0f));
+                products.push_back(std::make_unique<GlassWare>(name, 3.0f));
+                warehouse.newDelivery(std::move(products));
+                if (i % 3 == 0)
+                {
+                    warehouse.newOrder(R"({"order": [{"class":"BasicProduct"}, {"class":"GlassWare"}]})");
+                }
+                picojson::value report;
+                picojson::parse(report, warehouse.getOccupancyReport());
+                for (const auto &department : report.get("departmentsOccupancy").get<picojson::array>())
+                {
+                    if (department.get("occupancy").get<double>() > 100.0)
+                        overfilled = true;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_FALSE(overfilled.load());
+
+    picojson::value state;
+    picojson::parse(state, warehouse.saveWarehouseState());
+    for (const auto &department : state.get("warehouseState").get<picojson::array>())
+    {
+        const auto &items = department.get("items").get<picojson::array>();
+        EXPECT_LE(items.size(), 33u);
+        EXPECT_DOUBLE_EQ(department.get("occupancy").get<double>(), 3.0 * static_cast<double>(items.size()));
+    }
+}
+}  // namespace warehouse
@@ -0,0 +1,148 @@
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/ProductsList.hpp>
+#include <Serialization/BinarySnapshot.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+void writeFile(const std::string &path, const std::string &bytes)
+{
+    std::ofstream out(path, std::ios::binary);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<std::string> names(const warehouseInterface::Order &order)
+{
+    std::vector<std::string> result{};
+    for (const auto &product : order.products)
+        result.push_back(product->name());
+    return result;
+}
+
+std::vector<warehouseInterface::IProductPtr> delivery(int first, int count)
+{
+    ProductFactory productFactory{};
+    std::vector<warehouseInterface::IProductPtr> products{};
+    for (int i = first; i < first + count; ++i)
+    {
+        products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack " + std::to_string(i % 7), 0.5f));
+        products.emplace_back(productFactory.createProduct("GlassWare", "Glass " + std::to_string(i % 3), 1.5f));
+    }
+    return products;
+}
+}  // namespace
+
+TEST(MappedSnapshotTest, BehavesLikeLoadedSnapshot)
+{
+    Warehouse source{};
+    source.addDepartment(std::make_unique<SpecialDepartment>(1000.0f));
+    source.addDepartment(std::make_unique<SmallElectronicDepartment>(5.0f));
+    source.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1000.0f));
+    source.addDepartment(std::make_unique<ColdRoomDepartment>(10.0f));
+    source.newDelivery(delivery(0, 40));
+
+    const std::string path = ::testing::TempDir() + "warehouse_mapped_snapshot.bin";
+    writeFile(path, source.saveWarehouseStateBinary());
+
+    Warehouse loaded{};
+    ASSERT_TRUE(loaded.loadWarehouseStateBinary(source.saveWarehouseStateBinary()));
+    Warehouse mapped{};
+    ASSERT_TRUE(mapped.openWarehouseStateSnapshot(path));
+    std::remove(path.c_str());
+
+    EXPECT_EQ(mapped.saveWarehouseState(), source.saveWarehouseState());
+    EXPECT_EQ(mapped.getOccupancyReport(), loaded.getOccupancyReport());
+
+    const std::vector<std::string> orders{
+            "{\"order\": [{\"name\":\"Rack 3\"},{\"class\":\"GlassWare\"},{\"name\":\"Rack 3\"}]}",
+            "{\"order\": [{\"class\":\"IndustrialServerRack\",\"name\":\"Rack 6\"},{},{\"name\":\"Missing\"}]}",
+            "{\"order\": [{\"name\":\"Glass 2\"},{\"class\":\"IndustrialServerRack\"},{\"name\":\"Rack 0\"}]}",
+    };
+    for (int round = 0; round < 12; ++round)
+    {
+        for (const auto &order : orders)
+        {
+            EXPECT_EQ(names(mapped.newOrder(order)), names(loaded.newOrder(order)));
+            EXPECT_EQ(mapped.saveWarehouseState(), loaded.saveWarehouseState());
+        }
+        if (round % 4 == 0)
+        {
+            EXPECT_EQ(mapped.newDelivery(delivery(round, 3)), loaded.newDelivery(delivery(round, 3)));
+        }
+    }
+
+    EXPECT_EQ(mapped.getOccupancyReport(), loaded.getOccupancyReport());
+    EXPECT_EQ(mapped.saveWarehouseStateBinary(), loaded.saveWarehouseStateBinary());
+}
+
+TEST(MappedSnapshotTest, FifoDepartmentServesOldestItemFirst)
+{
+    SnapshotWriter writer;
+    writer.beginDepartment("HazardousDepartment", 100.0f);
+    const auto barrel = writer.productClass("ExplosiveBarrel");
+    writer.addItem(barrel, "First", 10.0f, 0);
+    writer.addItem(barrel, "Second", 20.0f, 0);
+
+    const std::string path = ::testing::TempDir() + "warehouse_mapped_fifo.bin";
+    writeFile(path, writer.finish());
+    Warehouse warehouse{};
+    ASSERT_TRUE(warehouse.openWarehouseStateSnapshot(path, true));
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(warehouse.newOrder("{\"order\": [{\"name\":\"Second\"}]}").products.empty());
+    auto order = warehouse.newOrder("{\"order\": [{\"name\":\"First\"},{\"name\":\"Second\"}]}");
+    ASSERT_EQ(order.products.size(), 2);
+    EXPECT_EQ(order.products[0]->name(), "First");
+    EXPECT_FLOAT_EQ(order.products[1]->itemSize(), 20.0f);
+    EXPECT_EQ(warehouse.getOccupancyReport(), "{\"departmentsOccupancy\":[{\"departmentName\":\"HazardousDepartment\",\"maxOccupancy\":100,"
+              "\"occupancy\":0}]}");
+}
+
+TEST(MappedSnapshotTest, RejectsInvalidSnapshots)
+{
+    Warehouse warehouse{};
+    EXPECT_FALSE(warehouse.openWarehouseStateSnapshot(::testing::TempDir() + "no_such_snapshot.bin"));
+
+    SnapshotWriter writer;
+    writer.beginDepartment("SpecialDepartment", 100.0f);
+    writer.addItem(writer.productClass("BasicProduct"), "Anything", 1.0f, 0);
+    const std::string path = ::testing::TempDir() + "warehouse_mapped_unknown.bin";
+    writeFile(path, writer.finish());
+    EXPECT_FALSE(warehouse.openWarehouseStateSnapshot(path));
+
+    auto corrupted = SnapshotWriter().finish();
+    corrupted.back() = 1;
+    writeFile(path, corrupted);
+    EXPECT_FALSE(warehouse.openWarehouseStateSnapshot(path, true));
+    std::remove(path.c_str());
+}
+
+TEST(MappedSnapshotTest, UnknownDepartmentKeepsCurrentState)
+{
+    Warehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+    warehouse.newDelivery(delivery(0, 3));
+    const auto json = warehouse.saveWarehouseState();
+
+    SnapshotWriter writer;
+    writer.beginDepartment("SpecialDepartment", 100.0f);
+    writer.addItem(writer.productClass("GlassWare"), "Glass", 1.0f, 0);
+    writer.beginDepartment("FreezerDepartment", 100.0f);
+    const std::string path = ::testing::TempDir() + "warehouse_mapped_unknown_department.bin";
+    writeFile(path, writer.finish());
+    EXPECT_FALSE(warehouse.openWarehouseStateSnapshot(path));
+    std::remove(path.c_str());
+
+    EXPECT_EQ(warehouse.saveWarehouseState(), json);
+}
+
+}  // namespace warehouse
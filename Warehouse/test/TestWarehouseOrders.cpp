@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <Warehouse/ConcurrentWarehouse.hpp>
+#include <Warehouse/TaskScheduler.hpp>
+#include <Warehouse/Warehouse.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+template <typename WarehouseType>
+void stock(WarehouseType &warehouse)
+{
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(20.0f));
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(100.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    for (int i = 0; i < 40; ++i)
+    {
+        const auto name = "Item " + std::to_string(i % 10);
+        products.push_back(std::make_unique<ElectronicParts>(name, 1.0f));
+        products.push_back(std::make_unique<GlassWare>(name, 1.0f));
+        products.push_back(std::make_unique<IndustrialServerRack>(name, 1.0f));
+        products.push_back(std::make_unique<AstronautsIceCream>(name, 1.0f));
+    }
+    warehouse.newDelivery(std::move(products));
+}
+
+/**
+ * @brief A wave of orders asking for more than the warehouse holds, by class, by name or both
+ */
+std::vector<warehouseInterface::OrderJson> wave()
+{
+    const char *classes[] = {"ElectronicParts", "GlassWare", "IndustrialServerRack", "AstronautsIceCream", "TV"};
+    std::vector<warehouseInterface::OrderJson> orders{};
+    for (int i = 0; i < 60; ++i)
+    {
+        std::string order = "{\"order\": [";
+        for (int line = 0; line < 4; ++line)
+        {
+            const auto name = "\"Item " + std::to_string((i + line * 3) % 12) + "\"";
+            const std::string className = std::string("\"") + classes[(i + line) % 5] + "\"";
+            if (line)
+                order += ",";
+            switch ((i + line) % 3)
+            {
+                case 0:
+                    order += "{\"name\":" + name + "}";
+                    break;
+                case 1:
+                    order += "{\"class\":" + className + "}";
+                    break;
+                default:
+                    order += "{\"class\":" + className + ",\"name\":" + name + "}";
+                    break;
+            }
+        }
+        orders.push_back(order + "]}");
+    }
+    return orders;
+}
+
+template <typename WarehouseType>
+std::vector<std::string> takenNames(WarehouseType &warehouse, const std::vector<warehouseInterface::OrderJson> &orders, bool batched)
+{
+    std::vector<warehouseInterface::Order> served{};
+    if (batched)
+        served = warehouse.newOrders(orders);
+    else
+        for (const auto &order : orders)
+            served.push_back(warehouse.newOrder(order));
+
+    std::vector<std::string> names{};
+    for (std::size_t i = 0; i < served.size(); ++i)
+    {
+        EXPECT_EQ(served[i].receipt, orders[i]);
+        std::string taken{};
+        for (const auto &product : served[i].products)
+            taken += dynamic_cast<const BaseProduct &>(*product).getClassName() + "/" + product->name() + ";";
+        names.push_back(taken);
+    }
+    return names;
+}
+}  // namespace
+
+TEST(WarehouseOrdersTest, BatchMatchesOrdersOneByOne)
+{
+    Warehouse sequential{};
+    Warehouse batched(std::make_shared<TaskScheduler>(2));
+    stock(sequential);
+    stock(batched);
+
+    const auto orders = wave();
+    EXPECT_EQ(takenNames(batched, orders, true), takenNames(sequential, orders, false));
+    EXPECT_EQ(batched.saveWarehouseState(), sequential.saveWarehouseState());
+    EXPECT_TRUE(batched.newOrders({}).empty());
+}
+
+TEST(WarehouseOrdersTest, ConcurrentBatchMatchesOrdersOneByOne)
+{
+    ConcurrentWarehouse sequential{};
+    ConcurrentWarehouse batched{};
+    stock(sequential);
+    stock(batched);
+
+    const auto orders = wave();
+    EXPECT_EQ(takenNames(batched, orders, true), takenNames(sequential, orders, false));
+    EXPECT_EQ(batched.getOccupancyReport(), sequential.getOccupancyReport());
+}
+
+TEST(WarehouseOrdersTest, MalformedOrderReachesTheCaller)
+{
+    Warehouse warehouse(std::make_shared<TaskScheduler>(2));
+    stock(warehouse);
+    const auto state = warehouse.saveWarehouseState();
+
+    // The malformed order is parsed on a worker, the whole wave fails before any item is taken
+    auto orders = wave();
+    orders.resize(63, orders.front());
+    orders.push_back("{\"items\": []}");
+    EXPECT_THROW(warehouse.newOrders(orders), std::out_of_range);
+    EXPECT_EQ(warehouse.saveWarehouseState(), state);
+
+    Warehouse sequential{};
+    stock(sequential);
+    EXPECT_THROW(sequential.newOrders(orders), std::out_of_range);
+    EXPECT_EQ(takenNames(warehouse, wave(), true), takenNames(sequential, wave(), true));
+}
+}  // namespace warehouse
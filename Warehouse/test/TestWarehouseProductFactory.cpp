@@ -3,7 +3,11 @@
 #include <gtest/gtest.h>
 
 #include <Factory/ProductFactory.hpp>
+#include <Factory/ProductRegistry.hpp>
+#include <Products/BasicProduct.hpp>
+#include <Products/ProductTypes.hpp>
 #include <Products/ProductsList.hpp>
+#include <Warehouse/Warehouse.h>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -31,6 +35,82 @@ TEST_P(ProductFactoryTest, CreateProduct)
     EXPECT_FLOAT_EQ(size, productPtr->itemSize());
 }
 
+TEST_P(ProductFactoryTest, CarriesTypeIdOfClassName)
+{
+    const auto &[className, name, size] = GetParam();
+
+    const auto type = productTypeId(className);
+    ASSERT_NE(type, ProductTypeId::unknown);
+    EXPECT_EQ(productTypeName(type), className);
+
+    const auto productPtr = factory.createProduct(type, name, size);
+    const auto *product = dynamic_cast<const BaseProduct *>(productPtr.get());
+    ASSERT_NE(nullptr, product);
+    EXPECT_EQ(product->typeId(), type);
+    EXPECT_EQ(product->getClassName(), className);
+    EXPECT_EQ(product->classSymbol(), productTypeSymbol(type));
+    EXPECT_EQ(product->classNameView(), className);
+}
+
+TEST_F(ProductFactoryTest, UnknownTypeId)
+{
+    EXPECT_EQ(productTypeId("Unknown class"), ProductTypeId::unknown);
+    EXPECT_EQ(productTypeId(""), ProductTypeId::unknown);
+    EXPECT_EQ(factory.createProduct(ProductTypeId::unknown, "nope", 1.0f), nullptr);
+
+    const BasicProduct basic("Basic", 1.0f, warehouseInterface::ProductLabelFlags::fragile);
+    EXPECT_EQ(basic.typeId(), ProductTypeId::unknown);
+    EXPECT_EQ(basic.classNameView(), "BasicProduct");
+}
+
+TEST(ProductRegistryTest, RegistersProductsAtRuntime)
+{
+    ProductRegistry registry;
+    EXPECT_EQ(registry.find("BasicProduct"), nullptr);
+
+    const auto createBasic = [](const std::string &name, float size) {
+        return warehouseInterface::IProductPtr(
+                std::make_unique<BasicProduct>(name, size, warehouseInterface::ProductLabelFlags::keepDry));
+    };
+    EXPECT_TRUE(registry.registerProduct("BasicProduct", createBasic));
+    EXPECT_FALSE(registry.registerProduct("BasicProduct", createBasic));
+    EXPECT_FALSE(registry.registerProduct("GlassWare", createBasic));
+
+    const auto product = registry.create("BasicProduct", "Box", 2.0f);
+    ASSERT_NE(product, nullptr);
+    EXPECT_EQ(product->name(), "Box");
+    EXPECT_EQ(product->itemFlags(), warehouseInterface::ProductLabelFlags::keepDry);
+    EXPECT_NE(dynamic_cast<const GlassWare *>(registry.create("GlassWare", "Glass", 1.0f).get()), nullptr);
+    EXPECT_EQ(registry.create("Glassware", "Glass", 1.0f), nullptr);
+    EXPECT_EQ(ProductRegistry::global().find("BasicProduct"), nullptr);
+}
+
+TEST_F(ProductFactoryTest, CreatesBatchForDelivery)
+{
+    std::vector<ProductSpec> specs{};
+    for (int i = 0; i < 1000; ++i)
+        specs.push_back(ProductSpec{"GlassWare", "Item " + std::to_string(i), 0.5f});
+    specs.push_back(ProductSpec{"Unknown class", "Nothing", 1.0f});
+
+    auto products = factory.createProducts(specs);
+    ASSERT_EQ(products.size(), specs.size());
+    EXPECT_EQ(products.back(), nullptr);
+    for (std::size_t i = 0; i + 1 < specs.size(); ++i)
+    {
+        ASSERT_NE(products[i], nullptr);
+        EXPECT_EQ(products[i]->name(), specs[i].name);
+        EXPECT_EQ(dynamic_cast<const BaseProduct &>(*products[i]).getClassName(), specs[i].className);
+    }
+
+    Warehouse warehouse{};
+    auto department = std::make_unique<SpecialDepartment>(1000.0f);
+    const auto *special = department.get();
+    warehouse.addDepartment(std::move(department));
+    warehouse.newDelivery(std::move(products));
+    EXPECT_FLOAT_EQ(special->getOccupancy(), 500.0f);
+    EXPECT_EQ(warehouse.newOrder("{\"order\": [{\"class\":\"GlassWare\",\"name\":\"Item 999\"}]}").products.size(), 1);
+}
+
 TEST_F(ProductFactoryTest, UnknownProduct)
 {
     EXPECT_THROW(factory.createProduct("Unknown class", "nope", -1.0), std::runtime_error);
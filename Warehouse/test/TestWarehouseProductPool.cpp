@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <Factory/ProductFactory.hpp>
+#include <Products/ProductPool.hpp>
+#include <Products/ProductsList.hpp>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+/**
+ * @brief Chooses pooled allocation before any test runs, the mode can only be chosen before the first product exists
+ */
+class PooledProducts : public ::testing::Environment
+{
+public:
+    PooledProducts() : pooledBeforeConfiguration(false), configured(false), firstProduct() {}
+
+    void SetUp() override
+    {
+        pooledBeforeConfiguration = ProductPool::global().pooled();
+        configured = ProductFactory::configure(ProductFactoryOptions{true});
+        firstProduct = ProductFactory().createProduct("GlassWare", "Glass", 1.0f);
+    }
+
+    void TearDown() override { firstProduct.reset(); }
+
+    bool pooledBeforeConfiguration;                ///< Pool mode before configure() was called
+    bool configured;                               ///< Result of configure() before the first product
+    warehouseInterface::IProductPtr firstProduct;  ///< Product latching the mode
+};
+
+auto *const pooledProducts = static_cast<PooledProducts *>(::testing::AddGlobalTestEnvironment(new PooledProducts()));
+}  // namespace
+
+TEST(ProductPoolTest, ConfigurationLatchesOnFirstProduct)
+{
+    EXPECT_FALSE(pooledProducts->pooledBeforeConfiguration);
+    EXPECT_TRUE(pooledProducts->configured);
+    ASSERT_NE(pooledProducts->firstProduct, nullptr);
+    EXPECT_TRUE(ProductPool::global().pooled());
+
+    EXPECT_TRUE(ProductFactory::configure(ProductFactoryOptions{true}));
+    EXPECT_FALSE(ProductFactory::configure(ProductFactoryOptions{false}));
+    EXPECT_TRUE(ProductPool::global().pooled());
+}
+
+TEST(ProductPoolTest, ReusesFreedBlocks)
+{
+    ProductPool pool;
+    std::set<void *> blocks{};
+    for (int i = 0; i < 200; ++i)
+        blocks.insert(pool.allocate(24));
+    EXPECT_EQ(blocks.size(), 200);
+    for (auto *block : blocks)
+        pool.deallocate(block, 24);
+
+    // A size of the same class takes one of the freed blocks
+    auto *reused = pool.allocate(32);
+    EXPECT_EQ(blocks.count(reused), 1);
+    pool.deallocate(reused, 32);
+
+    auto *large = pool.allocate(ProductPool::maxBlockSize + 1);
+    ASSERT_NE(large, nullptr);
+    pool.deallocate(large, ProductPool::maxBlockSize + 1);
+    EXPECT_EQ(ProductPool::blockSizeOf(24), 32);
+    EXPECT_EQ(ProductPool::blockSizeOf(1000), 1000);
+}
+
+TEST(ProductPoolTest, ProductsMoveBetweenThreads)
+{
+    constexpr int threadCount = 4;
+    constexpr int productCount = 5000;
+    std::vector<std::vector<warehouseInterface::IProductPtr>> products(threadCount);
+
+    // Products are created on one thread and destroyed on another, pooled since PooledProducts
+    ASSERT_TRUE(ProductPool::global().pooled());
+    std::vector<std::thread> producers{};
+    for (int t = 0; t < threadCount; ++t)
+    {
+        producers.emplace_back([&products, t]() {
+            for (int i = 0; i < productCount; ++i)
+                products[static_cast<std::size_t>(t)].push_back(std::make_unique<GlassWare>("Glass " + std::to_string(i), 1.0f));
+        });
+    }
+    for (auto &thread : producers)
+        thread.join();
+
+    std::vector<std::thread> consumers{};
+    for (int t = 0; t < threadCount; ++t)
+    {
+        consumers.emplace_back([&products, t]() {
+            auto &own = products[static_cast<std::size_t>((t + 1) % threadCount)];
+            for (std::size_t i = 0; i < own.size(); ++i)
+                ASSERT_EQ(own[i]->name(), "Glass " + std::to_string(i));
+            own.clear();
+        });
+    }
+    for (auto &thread : consumers)
+        thread.join();
+
+    const TV tv("TV", 2.0f);
+    auto copy = std::make_unique<TV>(tv);
+    EXPECT_EQ(copy->name(), "TV");
+}
+
+}  // namespace warehouse
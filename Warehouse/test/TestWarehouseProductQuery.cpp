@@ -0,0 +1,186 @@
+#include <PicoJson/picojson.h>
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Departments/ProductQuery.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/BasicProduct.hpp>
+#include <Products/ProductsList.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+/**
+ * @brief Department implemented outside BaseDepartment, reachable only through the string API
+ */
+class ForeignDepartment : public warehouseInterface::IDepartment
+{
+public:
+    bool addItem(warehouseInterface::IProductPtr item) override
+    {
+        item_ = std::move(item);
+        return true;
+    }
+
+    warehouseInterface::IProductPtr getItem(const warehouseInterface::ProductDescriptionJson &description) override
+    {
+        lastDescription_ = description;
+        return std::move(item_);
+    }
+
+    float getOccupancy() const override { return item_ ? item_->itemSize() : 0.0f; }
+    float getMaxOccupancy() const override { return 100.0f; }
+    float getMaxItemSize() const override { return 100.0f; }
+    warehouseInterface::ProductLabelFlags getSupportedFlags() const override
+    {
+        return warehouseInterface::ProductLabelFlags::keepFrozen | warehouseInterface::ProductLabelFlags::keepDry;
+    }
+    picojson::object asJson() const override { return picojson::object{}; }
+    warehouseInterface::DepartmentStateJson serialize() const override { return "{}"; }
+    picojson::array serializedItems() const override { return picojson::array{}; }
+    std::string departmentName() const override { return "ForeignDepartment"; }
+
+    std::string lastDescription_{};
+
+private:
+    warehouseInterface::IProductPtr item_{};
+};
+}  // namespace
+
+TEST(ProductQueryTest, ParseOptionalFields)
+{
+    const auto both = ProductQuery::parse("{\"class\":\"TV\",\"name\":\"Brave\"}");
+    EXPECT_EQ(both.className, std::optional<std::string>("TV"));
+    EXPECT_EQ(both.name, std::optional<std::string>("Brave"));
+
+    const auto none = ProductQuery::parse("{}");
+    EXPECT_FALSE(none.className.has_value());
+    EXPECT_FALSE(none.name.has_value());
+
+    TV tv("Brave", 40.0f);
+    EXPECT_TRUE(both.matches(tv));
+    EXPECT_TRUE(none.matches(tv));
+    EXPECT_FALSE(ProductQuery::parse("{\"class\":\"GlassWare\"}").matches(tv));
+
+    const auto sized = ProductQuery::parse("{\"minSize\":10,\"maxSize\":40}");
+    EXPECT_TRUE(sized.hasSizeRange());
+    EXPECT_TRUE(sized.matches(tv));
+    EXPECT_FALSE(ProductQuery::parse("{\"maxSize\":39.5}").matches(tv));
+    EXPECT_FALSE(none.hasSizeRange());
+}
+
+TEST(ProductQueryTest, SizeRangeTakesOldestMatchLikeLinearScan)
+{
+    struct Stored
+    {
+        bool rack;
+        std::string name;
+        float size;
+    };
+
+    SmallElectronicDepartment department(5000.0f);
+    std::vector<Stored> expected{};
+    std::uint64_t seed = 7;
+    const auto next = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return seed >> 33;
+    };
+    for (int i = 0; i < 2000; ++i)
+    {
+        const auto size = static_cast<float>(next() % 1000 + 1) / 1000.0f;
+        const bool rack = next() % 3 != 0;
+        const auto name = "Part " + std::to_string(i);
+        if (rack)
+            ASSERT_TRUE(department.addItem(std::make_unique<IndustrialServerRack>(name, size)));
+        else
+            ASSERT_TRUE(department.addItem(std::make_unique<BasicProduct>(name, size, warehouseInterface::ProductLabelFlags{})));
+        expected.push_back(Stored{rack, name, size});
+    }
+
+    std::size_t visited = 0;
+    department.forEachItemOfSize(0.25f, 0.5f, [&visited, &expected](const ItemStore::Item &item) {
+        while (visited < expected.size() && !(expected[visited].size >= 0.25f && expected[visited].size <= 0.5f))
+            ++visited;
+        ASSERT_LT(visited, expected.size());
+        EXPECT_EQ(item.size, expected[visited].size);
+        ++visited;
+    });
+
+    for (int i = 0; i < 1500; ++i)
+    {
+        const auto maxSize = static_cast<float>(next() % 1000 + 1) / 1000.0f;
+        const auto minSize = maxSize * static_cast<float>(next() % 4) / 4.0f;
+        const bool racksOnly = next() % 2 == 0;
+        const auto match = std::find_if(expected.begin(), expected.end(), [&](const Stored &stored) {
+            return (!racksOnly || stored.rack) && stored.size >= minSize && stored.size <= maxSize;
+        });
+
+        picojson::object description{};
+        if (racksOnly)
+            description["class"] = picojson::value("IndustrialServerRack");
+        description["minSize"] = picojson::value(static_cast<double>(minSize));
+        description["maxSize"] = picojson::value(static_cast<double>(maxSize));
+        auto item = department.getItem(picojson::value(description).serialize());
+        if (match == expected.end())
+        {
+            EXPECT_EQ(item, nullptr);
+            continue;
+        }
+        ASSERT_NE(item, nullptr);
+        EXPECT_EQ(item->name(), match->name);
+        expected.erase(match);
+    }
+
+    float occupancy = 0.0f;
+    for (const auto &stored : expected)
+        occupancy += stored.size;
+    EXPECT_NEAR(department.getOccupancy(), occupancy, 1e-3f);
+}
+
+TEST(ProductQueryTest, TakeItemFollowsAccessPolicy)
+{
+    HazardousDepartment hazardous(100.0f);
+    hazardous.addItem(std::make_unique<BasicProduct>("C4", 1.0f, warehouseInterface::ProductLabelFlags::explosives));
+    hazardous.addItem(std::make_unique<BasicProduct>("TNT", 1.0f, warehouseInterface::ProductLabelFlags::explosives));
+
+    EXPECT_EQ(hazardous.takeItem(ProductQuery{std::nullopt, std::string("TNT")}), nullptr);
+    auto item = hazardous.takeItem(ProductQuery{std::string("BasicProduct"), std::nullopt});
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(item->name(), "C4");
+
+    SpecialDepartment special(100.0f);
+    special.addItem(std::make_unique<GlassWare>("Plate", 1.0f));
+    special.addItem(std::make_unique<GlassWare>("Cup", 1.0f));
+
+    EXPECT_EQ(special.takeItem(ProductQuery{std::nullopt, std::string("Plate")}), nullptr);
+    item = special.takeItem(ProductQuery{});
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(item->name(), "Cup");
+    EXPECT_FLOAT_EQ(special.getOccupancy(), 1.0f);
+}
+
+TEST(ProductQueryTest, OrderFallsBackToSerializedDescription)
+{
+    Warehouse warehouse{};
+    auto foreign = std::make_unique<ForeignDepartment>();
+    auto *foreignPtr = foreign.get();
+    warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(10.0f));
+    warehouse.addDepartment(std::move(foreign));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(std::make_unique<AstronautsIceCream>("Vanilla", 1.0f));
+    warehouse.newDelivery(std::move(products));
+
+    auto order = warehouse.newOrder("{\"order\": [{\"class\":\"AstronautsIceCream\"}]}");
+    ASSERT_EQ(order.products.size(), 1);
+    EXPECT_EQ(order.products.back()->name(), "Vanilla");
+    EXPECT_EQ(foreignPtr->lastDescription_, "{\"class\":\"AstronautsIceCream\"}");
+}
+
+}  // namespace warehouse
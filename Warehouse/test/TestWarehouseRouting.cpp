@@ -0,0 +1,331 @@
+#include <PicoJson/picojson.h>
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/BasicProduct.hpp>
+#include <Products/ProductsList.hpp>
+#include <Warehouse/DepartmentRouter.hpp>
+#include <Warehouse/FitIndex.hpp>
+#include <Warehouse/TaskScheduler.hpp>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+TEST(DepartmentRouterTest, BucketsFollowSupportedFlags)
+{
+    SpecialDepartment special(10.0f);
+    OverSizeElectronicDepartment overSize(10.0f);
+    SmallElectronicDepartment smallElectronic(10.0f);
+
+    DepartmentRouter router{};
+    router.addDepartment(&special);
+    router.addDepartment(&overSize);
+    router.addDepartment(&smallElectronic);
+
+    const auto &esdCandidates = router.candidates(warehouseInterface::ProductLabelFlags::esdSensitive);
+    ASSERT_EQ(esdCandidates.size(), 2);
+    EXPECT_EQ(esdCandidates[0], &overSize);
+    EXPECT_EQ(esdCandidates[1], &smallElectronic);
+
+    const auto &glassCandidates = router.candidates(warehouseInterface::ProductLabelFlags::fragile |
+                                                    warehouseInterface::ProductLabelFlags::upWard);
+    ASSERT_EQ(glassCandidates.size(), 1);
+    EXPECT_EQ(glassCandidates[0], &special);
+
+    EXPECT_TRUE(router.candidates(warehouseInterface::ProductLabelFlags::keepFrozen).empty());
+    EXPECT_TRUE(router.candidates(static_cast<warehouseInterface::ProductLabelFlags>(1 << 8)).empty());
+
+    router.clear();
+    EXPECT_TRUE(router.candidates(warehouseInterface::ProductLabelFlags::esdSensitive).empty());
+}
+
+TEST(WarehouseRoutingTest, FirstDepartmentWithSpaceWins)
+{
+    ProductFactory productFactory{};
+    Warehouse warehouse{};
+
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(5.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(10.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack 1", 4.0f));
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack 2", 4.0f));
+    auto rawProductPtr = products.back().get();
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack 3", 20.0f));
+
+    EXPECT_EQ(warehouse.newDelivery(std::move(products)),
+              "{\"deliveryReport\":[{\"assignedDepartment\":\"OverSizeElectronicDepartment\",\"errorLog\":\"\",\"productName\":"
+              "\"Rack 1\",\"status\":\"Success\"},{\"assignedDepartment\":\"OverSizeElectronicDepartment\",\"errorLog\":\"\","
+              "\"productName\":\"Rack 2\",\"status\":\"Success\"},{\"assignedDepartment\":\"None\",\"errorLog\":\"Warehouse "
+              "cannot store this product. Lack of space in departments.\",\"productName\":\"Rack 3\",\"status\":\"Fail\"}]}");
+
+    EXPECT_EQ(warehouse.getOccupancyReport(),
+              "{\"departmentsOccupancy\":[{\"departmentName\":\"SpecialDepartment\",\"maxOccupancy\":100,\"occupancy\":0},{"
+              "\"departmentName\":\"OverSizeElectronicDepartment\",\"maxOccupancy\":5,\"occupancy\":4},{\"departmentName\":"
+              "\"OverSizeElectronicDepartment\",\"maxOccupancy\":10,\"occupancy\":4}]}");
+
+    auto order = warehouse.newOrder("{\"order\": [{\"name\":\"Rack 2\"}]}");
+    ASSERT_EQ(order.products.size(), 1);
+    EXPECT_EQ(order.products.back().get(), rawProductPtr);
+}
+
+TEST(WarehouseRoutingTest, RoutesRebuiltOnLoad)
+{
+    ProductFactory productFactory{};
+    Warehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(10.0f));
+
+    ASSERT_TRUE(warehouse.loadWarehouseState(
+            "{\"warehouseState\":[{\"class\":\"OverSizeElectronicDepartment\",\"items\":[],\"maxOccupancy\":10,"
+            "\"occupancy\":0}]}"));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("GlassWare", "Glass Plate", 0.5f));
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Server Rack", 2.0f));
+
+    EXPECT_EQ(warehouse.newDelivery(std::move(products)),
+              "{\"deliveryReport\":[{\"assignedDepartment\":\"None\",\"errorLog\":\"Warehouse cannot store this product. Lack "
+              "of space in departments.\",\"productName\":\"Glass Plate\",\"status\":\"Fail\"},{\"assignedDepartment\":"
+              "\"OverSizeElectronicDepartment\",\"errorLog\":\"\",\"productName\":\"Server Rack\",\"status\":\"Success\"}]}");
+}
+
+TEST(WarehouseRoutingTest, ParallelDeliveryMatchesSequential)
+{
+    const auto addDepartments = [](Warehouse &warehouse) {
+        warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(40.0f));
+        warehouse.addDepartment(std::make_unique<SpecialDepartment>(300.0f));
+        warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(400.0f));
+        warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(60.0f));
+        warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(200.0f));
+    };
+    const auto delivery = []() {
+        static const char *classes[] = {"IndustrialServerRack", "GlassWare",          "ExplosiveBarrel", "ElectronicParts",
+                                        "AstronautsIceCream",   "AcetoneBarrel",      "TV"};
+        ProductFactory productFactory{};
+        std::vector<warehouseInterface::IProductPtr> products{};
+        for (int i = 0; i < 5000; ++i)
+        {
+            if (i % 97 == 0)
+                products.emplace_back(nullptr);
+            products.emplace_back(productFactory.createProduct(classes[i % 7], "Item " + std::to_string(i), 0.1f * static_cast<float>(i % 13)));
+        }
+        return products;
+    };
+
+    Warehouse sequential{};
+    addDepartments(sequential);
+    Warehouse parallel(std::make_shared<TaskScheduler>(4));
+    addDepartments(parallel);
+    parallel.configureDelivery(DeliveryOptions{16});
+
+    EXPECT_EQ(parallel.newDelivery(delivery()), sequential.newDelivery(delivery()));
+    EXPECT_EQ(parallel.saveWarehouseState(), sequential.saveWarehouseState());
+    EXPECT_EQ(parallel.newDelivery(delivery()), sequential.newDelivery(delivery()));
+    EXPECT_EQ(parallel.getOccupancyReport(), sequential.getOccupancyReport());
+}
+
+namespace
+{
+std::vector<double> occupancies(const Warehouse &warehouse)
+{
+    picojson::value report;
+    picojson::parse(report, warehouse.getOccupancyReport());
+    std::vector<double> result{};
+    for (const auto &department : report.get("departmentsOccupancy").get<picojson::array>())
+        result.push_back(department.get("occupancy").get<double>());
+    return result;
+}
+
+std::vector<double> placeRacks(PlacementPolicy policy)
+{
+    ProductFactory productFactory{};
+    Warehouse warehouse{};
+    warehouse.configureDelivery(DeliveryOptions{4096, policy});
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(10.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(5.0f));
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(8.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    for (const auto *name : {"Rack 1", "Rack 2", "Rack 3"})
+        products.emplace_back(productFactory.createProduct("IndustrialServerRack", name, 4.0f));
+    warehouse.newDelivery(std::move(products));
+
+    // Space freed by an order is offered to the next delivery
+    EXPECT_EQ(warehouse.newOrder("{\"order\": [{\"name\":\"Rack 1\"}]}").products.size(), 1);
+    products.clear();
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack 4", 5.0f));
+    warehouse.newDelivery(std::move(products));
+    return occupancies(warehouse);
+}
+}  // namespace
+
+TEST(WarehouseRoutingTest, PlacementPoliciesChooseByFreeSpace)
+{
+    EXPECT_EQ(placeRacks(PlacementPolicy::firstFit), (std::vector<double>{9, 4, 0, 0}));
+    EXPECT_EQ(placeRacks(PlacementPolicy::bestFit), (std::vector<double>{0, 5, 0, 8}));
+    EXPECT_EQ(placeRacks(PlacementPolicy::worstFit), (std::vector<double>{9, 0, 0, 4}));
+}
+
+TEST(WarehouseRoutingTest, ParallelBestFitMatchesSequential)
+{
+    const auto addDepartments = [](Warehouse &warehouse) {
+        for (int i = 0; i < 8; ++i)
+            warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(40.0f + static_cast<float>(i * 7 % 5)));
+        warehouse.addDepartment(std::make_unique<SpecialDepartment>(300.0f));
+        warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(60.0f));
+        warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(200.0f));
+    };
+    const auto delivery = []() {
+        static const char *classes[] = {"IndustrialServerRack", "GlassWare", "ElectronicParts", "AstronautsIceCream", "TV"};
+        ProductFactory productFactory{};
+        std::vector<warehouseInterface::IProductPtr> products{};
+        for (int i = 0; i < 3000; ++i)
+            products.emplace_back(productFactory.createProduct(classes[i % 5], "Item " + std::to_string(i), 0.1f * static_cast<float>(i % 11)));
+        return products;
+    };
+
+    Warehouse sequential{};
+    addDepartments(sequential);
+    sequential.configureDelivery(DeliveryOptions{4096, PlacementPolicy::bestFit});
+    Warehouse parallel(std::make_shared<TaskScheduler>(4));
+    addDepartments(parallel);
+    parallel.configureDelivery(DeliveryOptions{16, PlacementPolicy::bestFit});
+
+    EXPECT_EQ(parallel.newDelivery(delivery()), sequential.newDelivery(delivery()));
+    EXPECT_EQ(parallel.saveWarehouseState(), sequential.saveWarehouseState());
+    EXPECT_EQ(parallel.newDelivery(delivery()), sequential.newDelivery(delivery()));
+    EXPECT_EQ(parallel.getOccupancyReport(), sequential.getOccupancyReport());
+}
+
+TEST(WarehouseRoutingTest, PackedDeliveryPlacesWhatGreedyStrands)
+{
+    const auto delivery = []() {
+        ProductFactory productFactory{};
+        std::vector<warehouseInterface::IProductPtr> products{};
+        for (const float size : {2.0f, 5.0f, 4.0f, 5.0f, 4.0f})
+            products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack " + std::to_string(products.size()), size));
+        products.emplace_back(nullptr);
+        return products;
+    };
+    const auto addDepartments = [](Warehouse &warehouse) {
+        warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(10.0f));
+        warehouse.addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+        warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(10.0f));
+    };
+
+    Warehouse greedy{};
+    addDepartments(greedy);
+    Warehouse packed{};
+    addDepartments(packed);
+    packed.configureDelivery(DeliveryOptions{4096, PlacementPolicy::firstFit, true});
+
+    // First fit decreasing: 5 and 5 fill the first department, 4, 4 and 2 the last one
+    const auto greedyReport = greedy.newDelivery(delivery());
+    const auto packedReport = packed.newDelivery(delivery());
+    EXPECT_NE(greedyReport.find("Fail"), std::string::npos);
+    EXPECT_EQ(packedReport.find("Fail"), std::string::npos);
+    EXPECT_EQ(occupancies(packed), (std::vector<double>{10, 0, 10}));
+
+    picojson::value report;
+    picojson::parse(report, packedReport);
+    const auto &entries = report.get("deliveryReport").get<picojson::array>();
+    ASSERT_EQ(entries.size(), 5);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        EXPECT_EQ(entries[i].get("productName").get<std::string>(), "Rack " + std::to_string(i));
+
+    // Departments store their racks in delivery order, not in packing order
+    const std::string line = "{\"class\":\"IndustrialServerRack\"}";
+    auto order = packed.newOrder("{\"order\": [" + line + "," + line + "," + line + "]}");
+    ASSERT_EQ(order.products.size(), 3);
+    EXPECT_EQ(order.products[0]->name(), "Rack 1");
+    EXPECT_EQ(order.products[1]->name(), "Rack 3");
+    EXPECT_EQ(order.products[2]->name(), "Rack 0");
+}
+
+TEST(WarehouseRoutingTest, PackedDeliveryMovesItemsToMakeRoom)
+{
+    Warehouse warehouse{};
+    warehouse.configureDelivery(DeliveryOptions{4096, PlacementPolicy::firstFit, true});
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1.0f));
+    warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(1.0f));
+
+    // The unlabeled box fits both departments, the rack only the first one
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.push_back(std::make_unique<BasicProduct>("Box", 0.6f, static_cast<warehouseInterface::ProductLabelFlags>(0)));
+    products.push_back(std::make_unique<IndustrialServerRack>("Rack", 0.5f));
+    EXPECT_EQ(warehouse.newDelivery(std::move(products)),
+              "{\"deliveryReport\":[{\"assignedDepartment\":\"ColdRoomDepartment\",\"errorLog\":\"\",\"productName\":\"Box\","
+              "\"status\":\"Success\"},{\"assignedDepartment\":\"OverSizeElectronicDepartment\",\"errorLog\":\"\","
+              "\"productName\":\"Rack\",\"status\":\"Success\"}]}");
+}
+
+TEST(FitIndexTest, FirstFitFindsLeftmostDepartmentWithRoom)
+{
+    const warehouseInterface::ProductLabelFlags flags[] = {warehouseInterface::ProductLabelFlags::esdSensitive,
+                                                           warehouseInterface::ProductLabelFlags::keepFrozen,
+                                                           warehouseInterface::ProductLabelFlags::esdSensitive |
+                                                                   warehouseInterface::ProductLabelFlags::keepDry};
+    std::vector<unsigned> supported{};
+    std::vector<OccupancyUnits> free{};
+    FitIndex index{};
+    index.reset(PlacementPolicy::firstFit);
+
+    std::uint64_t seed = 7;
+    const auto next = [&seed](std::uint64_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<OccupancyUnits>((seed >> 33) % bound);
+    };
+    for (int i = 0; i < 300; ++i)
+    {
+        const auto departmentFlags = flags[next(3)];
+        supported.push_back(static_cast<unsigned>(departmentFlags));
+        free.push_back(next(1000));
+        index.addDepartment(departmentFlags, free.back());
+    }
+
+    // Some departments reject every item, as a too small maximum item size would
+    const auto fits = [](std::uint32_t department) { return department % 7 != 3; };
+    for (int query = 0; query < 2000; ++query)
+    {
+        const auto mask = static_cast<unsigned>(flags[next(3)]);
+        const auto size = next(1000);
+        auto expected = FitIndex::noDepartment;
+        for (std::uint32_t department = 0; department < free.size(); ++department)
+        {
+            if ((mask & supported[department]) == mask && free[department] >= size && fits(department))
+            {
+                expected = department;
+                break;
+            }
+        }
+        ASSERT_EQ(index.select(static_cast<warehouseInterface::ProductLabelFlags>(mask), size, fits), expected);
+
+        const auto changed = static_cast<std::uint32_t>(next(free.size()));
+        free[changed] = next(1000);
+        index.update(changed, free[changed]);
+    }
+}
+
+TEST(WarehouseRoutingTest, DepartmentsAddedAfterADeliveryAreCandidates)
+{
+    ProductFactory productFactory{};
+    Warehouse warehouse{};
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack 1", 1.0f));
+    warehouse.newDelivery(std::move(products));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1.0f));
+    products.clear();
+    products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack 2", 1.0f));
+    warehouse.newDelivery(std::move(products));
+
+    EXPECT_EQ(occupancies(warehouse), (std::vector<double>{1, 1}));
+}
+
+}  // namespace warehouse
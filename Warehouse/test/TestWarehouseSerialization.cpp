@@ -0,0 +1,139 @@
+#include <PicoJson/picojson.h>
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/ProductsList.hpp>
+#include <Serialization/JsonSink.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+std::string canonical(const std::string &json)
+{
+    picojson::value val;
+    const auto err = picojson::parse(val, json);
+    EXPECT_TRUE(err.empty()) << err;
+    return val.serialize();
+}
+
+void fillWarehouse(Warehouse &warehouse)
+{
+    ProductFactory productFactory{};
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(1000.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1000.3f));
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(7.0f));
+    warehouse.addDepartment(std::make_unique<ColdRoomDepartment>(10.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("GlassWare", "Plate \"large\" / tab\t", 0.1f));
+    products.emplace_back(productFactory.createProduct("GlassWare", "Zażółć \x01", 12.25f));
+    for (int i = 0; i < 300; ++i)
+    {
+        products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack " + std::to_string(i), 0.3f));
+    }
+    warehouse.newDelivery(std::move(products));
+    warehouse.newOrder("{\"order\": [{\"name\":\"Rack 7\"},{\"name\":\"Rack 200\"}]}");
+}
+}  // namespace
+
+TEST(JsonSinkTest, MatchesPicojsonOutput)
+{
+    JsonSink sink;
+    sink.beginObject();
+    sink.key("a");
+    sink.beginArray();
+    sink.value(1.0);
+    sink.value(0.1);
+    sink.value(-3.5e300);
+    sink.value(static_cast<double>(1ULL << 60));
+    sink.value("x\ny");
+    sink.beginObject();
+    sink.endObject();
+    sink.endArray();
+    sink.key("b");
+    sink.rawValue("[]");
+    sink.endObject();
+
+    const auto json = sink.release();
+    EXPECT_EQ(json, canonical(json));
+    EXPECT_THROW(JsonSink().value(std::nan("")), std::overflow_error);
+}
+
+TEST(WarehouseSerializationTest, StateIsCanonicalPicojson)
+{
+    Warehouse warehouse{};
+    fillWarehouse(warehouse);
+
+    const auto state = warehouse.saveWarehouseState();
+    EXPECT_EQ(state, canonical(state));
+    EXPECT_NE(state.find("\"name\":\"Rack 299\""), std::string::npos);
+    EXPECT_EQ(state.find("\"name\":\"Rack 7\""), std::string::npos);
+
+    std::ostringstream streamed;
+    warehouse.writeWarehouseState(streamed);
+    EXPECT_EQ(streamed.str(), state);
+}
+
+TEST(WarehouseSerializationTest, DepartmentMatchesDomSerialization)
+{
+    SpecialDepartment department(100.0f);
+    department.addItem(std::make_unique<GlassWare>("Glass Plate", 0.5f));
+    department.addItem(std::make_unique<GlassWare>("Vase", 40.1f));
+
+    EXPECT_EQ(department.serialize(), picojson::value(department.asJson()).serialize());
+}
+
+TEST(WarehouseSerializationTest, OccupancyReportIsCachedUntilDepartmentsChange)
+{
+    Warehouse warehouse{};
+    fillWarehouse(warehouse);
+
+    // The DOM rendering the report had before it was cached
+    const auto domReport = [&warehouse]() {
+        picojson::array departments;
+        picojson::value state;
+        picojson::parse(state, warehouse.saveWarehouseState());
+        for (const auto &department : state.get("warehouseState").get<picojson::array>())
+        {
+            picojson::object dept;
+            dept["departmentName"] = department.get("class");
+            dept["maxOccupancy"] = department.get("maxOccupancy");
+            dept["occupancy"] = department.get("occupancy");
+            departments.push_back(picojson::value(dept));
+        }
+        picojson::object result;
+        result["departmentsOccupancy"] = picojson::value(departments);
+        return picojson::value(result).serialize();
+    };
+
+    const auto report = warehouse.occupancyReport();
+    EXPECT_EQ(*report, domReport());
+    EXPECT_EQ(warehouse.getOccupancyReport(), *report);
+    EXPECT_EQ(warehouse.occupancyReport(), report);
+
+    warehouse.newOrder("{\"order\": [{\"name\":\"Rack 8\"}]}");
+    const auto changed = warehouse.occupancyReport();
+    EXPECT_NE(changed, report);
+    EXPECT_EQ(*changed, domReport());
+
+    ProductFactory productFactory{};
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("AstronautsIceCream", "Vanilla", 1.5f));
+    warehouse.newDelivery(std::move(products));
+    EXPECT_EQ(warehouse.getOccupancyReport(), domReport());
+
+    ASSERT_TRUE(warehouse.loadWarehouseState(warehouse.saveWarehouseState()));
+    EXPECT_EQ(warehouse.getOccupancyReport(), domReport());
+    warehouse.addDepartment(std::make_unique<HazardousDepartment>(5.0f));
+    EXPECT_EQ(warehouse.getOccupancyReport(), domReport());
+    EXPECT_EQ(warehouse.releaseDepartments().size(), 5u);
+    EXPECT_EQ(warehouse.getOccupancyReport(), "{\"departmentsOccupancy\":[]}");
+}
+
+}  // namespace warehouse
@@ -0,0 +1,89 @@
+#include <Warehouse/Warehouse.h>
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Factory/ProductFactory.hpp>
+#include <Products/ProductsList.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace warehouse
+{
+namespace
+{
+void fillWarehouse(Warehouse &warehouse)
+{
+    ProductFactory productFactory{};
+    warehouse.addDepartment(std::make_unique<SpecialDepartment>(1000.0f));
+    warehouse.addDepartment(std::make_unique<OverSizeElectronicDepartment>(1000.3f));
+    warehouse.addDepartment(std::make_unique<SmallElectronicDepartment>(7.0f));
+
+    std::vector<warehouseInterface::IProductPtr> products{};
+    products.emplace_back(productFactory.createProduct("GlassWare", "Plate \"large\"", 0.1f));
+    for (int i = 0; i < 500; ++i)
+    {
+        products.emplace_back(productFactory.createProduct("IndustrialServerRack", "Rack " + std::to_string(i), 0.3f));
+    }
+    warehouse.newDelivery(std::move(products));
+}
+}  // namespace
+
+TEST(WarehouseStateLoaderTest, RoundTripFromStringStreamAndFile)
+{
+    Warehouse source{};
+    fillWarehouse(source);
+    const auto state = source.saveWarehouseState();
+
+    Warehouse fromString{};
+    ASSERT_TRUE(fromString.loadWarehouseState(state));
+    EXPECT_EQ(fromString.saveWarehouseState(), state);
+
+    std::istringstream in(state);
+    Warehouse fromStream{};
+    ASSERT_TRUE(fromStream.readWarehouseState(in));
+    EXPECT_EQ(fromStream.saveWarehouseState(), state);
+
+    const std::string path = ::testing::TempDir() + "warehouse_state_loader.json";
+    {
+        std::ofstream out(path, std::ios::binary);
+        source.writeWarehouseState(out);
+    }
+    Warehouse fromFile{};
+    ASSERT_TRUE(fromFile.readWarehouseStateFile(path));
+    EXPECT_EQ(fromFile.saveWarehouseState(), state);
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(fromFile.readWarehouseStateFile(path));
+}
+
+TEST(WarehouseStateLoaderTest, AcceptsAnyKeyOrder)
+{
+    Warehouse warehouse{};
+    ASSERT_TRUE(warehouse.loadWarehouseState(
+            "{\"version\": [1, {\"x\": null}], \"warehouseState\": [{\"items\": ["
+            "{\"size\": 2, \"name\": \"Cup\", \"class\": \"GlassWare\", \"color\": \"red\"},"
+            "{\"class\": \"NoSuchProduct\", \"name\": \"Ghost\", \"size\": 1}],"
+            " \"occupancy\": 0, \"maxOccupancy\": 10, \"class\": \"SpecialDepartment\"}]}"));
+
+    EXPECT_EQ(warehouse.saveWarehouseState(),
+              "{\"warehouseState\":[{\"class\":\"SpecialDepartment\",\"items\":[{\"class\":\"GlassWare\","
+              "\"flags\":[\"fragile\",\"upWard\"],\"name\":\"Cup\",\"size\":2}],\"maxOccupancy\":10,\"occupancy\":2}]}");
+}
+
+TEST(WarehouseStateLoaderTest, RejectsInvalidState)
+{
+    Warehouse warehouse{};
+    EXPECT_FALSE(warehouse.loadWarehouseState(""));
+    EXPECT_FALSE(warehouse.loadWarehouseState("[]"));
+    EXPECT_FALSE(warehouse.loadWarehouseState("{\"state\": []}"));
+    EXPECT_FALSE(warehouse.loadWarehouseState("{\"warehouseState\": [{\"class\": \"Attic\", \"maxOccupancy\": 1}]}"));
+    EXPECT_FALSE(warehouse.loadWarehouseState("{\"warehouseState\": [{\"class\": \"SpecialDepartment\"}]}"));
+    EXPECT_FALSE(warehouse.loadWarehouseState(
+            "{\"warehouseState\": [{\"class\": \"SpecialDepartment\", \"maxOccupancy\": 1, \"items\": [{\"name\": \"Cup\"}]}]}"));
+    EXPECT_FALSE(warehouse.loadWarehouseState("{\"warehouseState\": [{\"class\": \"SpecialDepartment\", \"maxOccupancy\": 1"));
+}
+
+}  // namespace warehouse
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <Departments/ProductQuery.hpp>
+#include <Products/ProductsList.hpp>
+#include <Products/StringInterner.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warehouse
+{
+
+TEST(StringInternerTest, EqualStringsShareStableSymbols)
+{
+    StringInterner interner;
+    EXPECT_EQ(interner.find("Glass"), noSymbol);
+    EXPECT_EQ(interner.view(noSymbol), "");
+
+    const auto glass = interner.intern("Glass");
+    const auto empty = interner.intern("");
+    const std::string longName(40000, 'x');
+    const auto longSymbol = interner.intern(longName);
+    EXPECT_NE(glass, noSymbol);
+    EXPECT_NE(empty, noSymbol);
+    EXPECT_NE(glass, empty);
+    EXPECT_EQ(interner.intern(std::string("Gla") + "ss"), glass);
+    EXPECT_EQ(interner.find("Glass"), glass);
+
+    // Views stay valid while the symbol table and the character blocks grow
+    const auto glassView = interner.view(glass);
+    for (int i = 0; i < 20000; ++i)
+        interner.intern("Name " + std::to_string(i));
+    EXPECT_EQ(interner.size(), 20003);
+    EXPECT_EQ(glassView.data(), interner.view(glass).data());
+    EXPECT_EQ(interner.view(glass), "Glass");
+    EXPECT_EQ(interner.view(empty), "");
+    EXPECT_EQ(interner.view(longSymbol), longName);
+    EXPECT_EQ(interner.view(interner.find("Name 19999")), "Name 19999");
+}
+
+TEST(StringInternerTest, ConcurrentInterningAgrees)
+{
+    StringInterner interner;
+    constexpr int threadCount = 8;
+    constexpr int nameCount = 5000;
+    std::vector<std::vector<Symbol>> symbols(threadCount, std::vector<Symbol>(nameCount));
+
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&interner, &symbols, t]() {
+            for (int i = 0; i < nameCount; ++i)
+            {
+                // Every thread starts at a different name
+                const int name = (i + t * 997) % nameCount;
+                symbols[static_cast<std::size_t>(t)][static_cast<std::size_t>(name)] = interner.intern("Item " + std::to_string(name));
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(interner.size(), nameCount);
+    for (std::size_t i = 0; i < nameCount; ++i)
+    {
+        for (std::size_t t = 1; t < threadCount; ++t)
+            EXPECT_EQ(symbols[t][i], symbols[0][i]);
+        EXPECT_EQ(interner.view(symbols[0][i]), "Item " + std::to_string(i));
+    }
+}
+
+TEST(StringInternerTest, ProductsAndQueriesUseGlobalSymbols)
+{
+    const GlassWare glass("Crystal vase with a long name", 1.0f);
+    const TV tv("Crystal vase with a long name", 1.0f);
+    auto &interner = StringInterner::global();
+
+    EXPECT_EQ(glass.nameSymbol(), tv.nameSymbol());
+    EXPECT_EQ(glass.nameView(), "Crystal vase with a long name");
+    const auto glassClass = glass.classSymbol();
+    EXPECT_EQ(glassClass, interner.find("GlassWare"));
+    EXPECT_EQ(glass.classNameView(), glass.getClassName());
+
+    const auto query = ProductQuery{std::string("GlassWare"), std::string("Crystal vase with a long name")}.symbols();
+    EXPECT_TRUE(query.matches(glass.classSymbol(), glass.nameSymbol()));
+    EXPECT_FALSE(query.matches(tv.classSymbol(), tv.nameSymbol()));
+
+    const auto unknown = ProductQuery{std::nullopt, std::string("Never stored anywhere")}.symbols();
+    EXPECT_TRUE(unknown.matchesNothing);
+    EXPECT_EQ(interner.find("Never stored anywhere"), noSymbol);
+}
+
+}  // namespace warehouse
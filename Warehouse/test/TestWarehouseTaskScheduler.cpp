@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <Departments/DepartmentsList.hpp>
+#include <Products/ProductsList.hpp>
+#include <Warehouse/TaskScheduler.hpp>
+#include <Warehouse/Warehouse.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace warehouse
+{
+TEST(TaskSchedulerTest, RunsEveryIndexOnce)
+{
+    TaskScheduler scheduler(4);
+    EXPECT_EQ(scheduler.size(), 4);
+
+    std::vector<std::atomic<int>> runs(1000);
+    for (int round = 0; round < 3; ++round)
+        scheduler.parallelFor(runs.size(), [&runs](std::size_t i) { runs[i].fetch_add(1); });
+    for (const auto &count : runs)
+        EXPECT_EQ(count.load(), 3);
+}
+
+TEST(TaskSchedulerTest, TaskExceptionsReachTheWaitingThread)
+{
+    TaskScheduler scheduler(2);
+    std::atomic<int> finished{0};
+    {
+        TaskGroup group(scheduler);
+        for (int i = 0; i < 16; ++i)
+        {
+            group.run([&finished, i]() {
+                if (i == 5)
+                    throw std::runtime_error("task failed");
+                ++finished;
+            });
+        }
+        EXPECT_THROW(group.wait(), std::runtime_error);
+        EXPECT_EQ(finished.load(), 15);
+        EXPECT_NO_THROW(group.wait());
+    }
+
+    // Chunks on the workers and on the calling thread both end the loop with the exception
+    for (const std::size_t failing : {std::size_t{0}, std::size_t{999}})
+    {
+        std::vector<std::atomic<int>> runs(1000);
+        EXPECT_THROW(scheduler.parallelFor(runs.size(),
+                                           [&runs, failing](std::size_t i) {
+                                               if (i == failing)
+                                                   throw std::out_of_range("index");
+                                               runs[i].fetch_add(1);
+                                           }),
+                     std::out_of_range);
+        EXPECT_EQ(runs[failing].load(), 0);
+    }
+
+    std::vector<std::atomic<int>> runs(100);
+    scheduler.parallelFor(runs.size(), [&runs](std::size_t i) { runs[i].fetch_add(1); });
+    for (const auto &count : runs)
+        EXPECT_EQ(count.load(), 1);
+}
+
+TEST(TaskSchedulerTest, NestedGroupsFinishAndIdleWorkersSteal)
+{
+    TaskScheduler scheduler(3);
+    std::mutex mutex{};
+    std::set<std::thread::id> threads{};
+    std::atomic<int> leaves{0};
+
+    // Every task waits for tasks it submitted to its own deque, only thieves and waiting threads can run them
+    TaskGroup outer(scheduler);
+    for (int i = 0; i < 8; ++i)
+    {
+        outer.run([&]() {
+            TaskGroup inner(scheduler);
+            for (int j = 0; j < 8; ++j)
+            {
+                inner.run([&]() {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                    ++leaves;
+                });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+
+    EXPECT_EQ(leaves.load(), 64);
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(TaskSchedulerTest, WarehouseStateIsSavedInParallel)
+{
+    Warehouse sequential{};
+    Warehouse parallel(std::make_shared<TaskScheduler>(2));
+    for (auto *warehouse : {&sequential, &parallel})
+    {
+        warehouse->addDepartment(std::make_unique<SpecialDepartment>(100.0f));
+        warehouse->addDepartment(std::make_unique<OverSizeElectronicDepartment>(100.0f));
+        warehouse->addDepartment(std::make_unique<ColdRoomDepartment>(100.0f));
+
+        std::vector<warehouseInterface::IProductPtr> products{};
+        for (int i = 0; i < 30; ++i)
+        {
+            products.push_back(std::make_unique<GlassWare>("Glass " + std::to_string(i), 1.0f));
+            products.push_back(std::make_unique<IndustrialServerRack>("Rack " + std::to_string(i), 2.0f));
+            products.push_back(std::make_unique<AstronautsIceCream>("Ice " + std::to_string(i), 0.5f));
+        }
+        warehouse->newDelivery(std::move(products));
+    }
+
+    EXPECT_EQ(parallel.saveWarehouseState(), sequential.saveWarehouseState());
+}
+}  // namespace warehouse